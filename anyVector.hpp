@@ -0,0 +1,357 @@
+#pragma once
+
+#include "customVector.hpp"
+#include "vectorHash.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// A column whose element type is chosen at run time: a type tag plus the raw elements in
+// cache-line aligned byte storage. Kernels are written once as templates over the element type
+// and dispatch_element_type() selects the instantiation once per call, so the inner loops run on
+// plain T arrays instead of testing a tag (or a std::variant index) per element.
+enum class ElementType : uint8_t { Int8, UInt8, Int16, UInt16, Int32, UInt32, Int64, UInt64, Float32, Float64 };
+
+template <typename T>
+struct ElementTag {
+    using type = T;
+};
+
+template <typename T> struct ElementTypeOf;
+template <> struct ElementTypeOf<int8_t> { static constexpr ElementType value = ElementType::Int8; };
+template <> struct ElementTypeOf<uint8_t> { static constexpr ElementType value = ElementType::UInt8; };
+template <> struct ElementTypeOf<int16_t> { static constexpr ElementType value = ElementType::Int16; };
+template <> struct ElementTypeOf<uint16_t> { static constexpr ElementType value = ElementType::UInt16; };
+template <> struct ElementTypeOf<int32_t> { static constexpr ElementType value = ElementType::Int32; };
+template <> struct ElementTypeOf<uint32_t> { static constexpr ElementType value = ElementType::UInt32; };
+template <> struct ElementTypeOf<int64_t> { static constexpr ElementType value = ElementType::Int64; };
+template <> struct ElementTypeOf<uint64_t> { static constexpr ElementType value = ElementType::UInt64; };
+template <> struct ElementTypeOf<float> { static constexpr ElementType value = ElementType::Float32; };
+template <> struct ElementTypeOf<double> { static constexpr ElementType value = ElementType::Float64; };
+
+// Calls f(ElementTag<T>{}) for the T named by type. Every branch must return the same type.
+template <typename F>
+decltype(auto) dispatch_element_type(ElementType type, F&& f) {
+    switch (type) {
+    case ElementType::Int8: return f(ElementTag<int8_t>{});
+    case ElementType::UInt8: return f(ElementTag<uint8_t>{});
+    case ElementType::Int16: return f(ElementTag<int16_t>{});
+    case ElementType::UInt16: return f(ElementTag<uint16_t>{});
+    case ElementType::Int32: return f(ElementTag<int32_t>{});
+    case ElementType::UInt32: return f(ElementTag<uint32_t>{});
+    case ElementType::Int64: return f(ElementTag<int64_t>{});
+    case ElementType::UInt64: return f(ElementTag<uint64_t>{});
+    case ElementType::Float32: return f(ElementTag<float>{});
+    case ElementType::Float64: break;
+    }
+    return f(ElementTag<double>{});
+}
+
+inline size_t element_size(ElementType type) {
+    return dispatch_element_type(type, [](auto tag) { return sizeof(typename decltype(tag)::type); });
+}
+
+inline const char* element_type_name(ElementType type) {
+    switch (type) {
+    case ElementType::Int8: return "int8";
+    case ElementType::UInt8: return "uint8";
+    case ElementType::Int16: return "int16";
+    case ElementType::UInt16: return "uint16";
+    case ElementType::Int32: return "int32";
+    case ElementType::UInt32: return "uint32";
+    case ElementType::Int64: return "int64";
+    case ElementType::UInt64: return "uint64";
+    case ElementType::Float32: return "float32";
+    case ElementType::Float64: return "float64";
+    }
+    return "unknown";
+}
+
+class AnyVector {
+public:
+    using Storage = Vector<std::byte, AlignedAllocator<std::byte, 64>>;
+
+    explicit AnyVector(ElementType type = ElementType::Int64) : type_(type), element_size_(::element_size(type)) {}
+
+    AnyVector(ElementType type, size_t n) : AnyVector(type) { resize(n); }
+
+    template <typename T, typename Allocator>
+    static AnyVector from(const Vector<T, Allocator>& values) {
+        AnyVector out(ElementTypeOf<T>::value);
+        out.bytes_.resize_for_overwrite(values.size() * sizeof(T));
+        if (!values.empty()) {
+            std::memcpy(out.bytes_.data(), values.data(), values.size() * sizeof(T));
+        }
+        return out;
+    }
+
+    ElementType type() const noexcept { return type_; }
+    size_t element_size() const noexcept { return element_size_; }
+    size_t size() const noexcept { return bytes_.size() / element_size_; }
+    bool empty() const noexcept { return bytes_.empty(); }
+    size_t size_bytes() const noexcept { return bytes_.size(); }
+    const void* data() const noexcept { return bytes_.data(); }
+    void* data() noexcept { return bytes_.data(); }
+    const Storage& bytes() const noexcept { return bytes_; }
+
+    void reserve(size_t n) { bytes_.reserve(n * element_size_); }
+    void clear() noexcept { bytes_.clear(); }
+
+    // New elements are zero.
+    void resize(size_t n) { bytes_.resize(n * element_size_, std::byte{0}); }
+
+    // New elements are left uninitialized, for kernels that write every slot.
+    void resize_for_overwrite(size_t n) { bytes_.resize_for_overwrite(n * element_size_); }
+
+    template <typename T>
+    bool holds() const noexcept {
+        return type_ == ElementTypeOf<T>::value;
+    }
+
+    // Typed access; T must match type() exactly, otherwise std::invalid_argument is thrown.
+    template <typename T>
+    T* data_as() {
+        check_type<T>();
+        return reinterpret_cast<T*>(bytes_.data());
+    }
+
+    template <typename T>
+    const T* data_as() const {
+        check_type<T>();
+        return reinterpret_cast<const T*>(bytes_.data());
+    }
+
+    template <typename T>
+    T get(size_t index) const {
+        check_index(index);
+        return data_as<T>()[index];
+    }
+
+    template <typename T>
+    void set(size_t index, T value) {
+        check_index(index);
+        data_as<T>()[index] = value;
+    }
+
+    template <typename T>
+    void push_back(T value) {
+        check_type<T>();
+        size_t old = bytes_.size();
+        bytes_.resize_for_overwrite(old + sizeof(T));
+        std::memcpy(bytes_.data() + old, &value, sizeof(T));
+    }
+
+    void append(const AnyVector& other) {
+        if (other.type_ != type_) {
+            VECTOR_THROW(std::invalid_argument("AnyVector element type mismatch"));
+        }
+        size_t old = bytes_.size();
+        bytes_.resize_for_overwrite(old + other.bytes_.size());
+        if (!other.bytes_.empty()) {
+            std::memcpy(bytes_.data() + old, other.bytes_.data(), other.bytes_.size());
+        }
+    }
+
+    template <typename T, typename Allocator = SimpleAllocator<T>>
+    Vector<T, Allocator> to_vector() const {
+        const T* p = data_as<T>();
+        Vector<T, Allocator> out;
+        out.resize_for_overwrite(size());
+        std::copy(p, p + size(), out.data());
+        return out;
+    }
+
+    // Runs f(const T* data, size_t n) on the concrete element type, once for the whole column.
+    template <typename F>
+    decltype(auto) visit(F&& f) const {
+        return dispatch_element_type(type_, [&](auto tag) -> decltype(auto) {
+            using T = typename decltype(tag)::type;
+            return f(reinterpret_cast<const T*>(bytes_.data()), size());
+        });
+    }
+
+    template <typename F>
+    decltype(auto) visit(F&& f) {
+        return dispatch_element_type(type_, [&](auto tag) -> decltype(auto) {
+            using T = typename decltype(tag)::type;
+            return f(reinterpret_cast<T*>(bytes_.data()), size());
+        });
+    }
+
+    friend bool operator==(const AnyVector& a, const AnyVector& b) {
+        return a.type_ == b.type_ && a.bytes_.size() == b.bytes_.size()
+               && a.visit([&](const auto* x, size_t n) { return std::equal(x, x + n, reinterpret_cast<decltype(x)>(b.bytes_.data())); });
+    }
+
+    friend bool operator!=(const AnyVector& a, const AnyVector& b) { return !(a == b); }
+
+private:
+    Storage bytes_;
+    ElementType type_;
+    size_t element_size_;
+
+    template <typename T>
+    void check_type() const {
+        if (type_ != ElementTypeOf<T>::value) {
+            VECTOR_THROW(std::invalid_argument("AnyVector element type mismatch"));
+        }
+    }
+
+    void check_index(size_t index) const {
+        if (index >= size()) {
+            VECTOR_THROW(std::out_of_range("AnyVector index out of range"));
+        }
+    }
+};
+
+namespace detail {
+
+// NaN sorts after every number, so float columns have a strict weak order.
+template <typename T>
+bool any_less(T a, T b) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return a < b || (std::isnan(b) && !std::isnan(a));
+    } else {
+        return a < b;
+    }
+}
+
+template <typename T>
+uint64_t any_key_bits(T value) {
+    if constexpr (std::is_floating_point_v<T>) {
+        if (value == T(0)) {
+            return 0; // -0.0 and 0.0 compare equal and must hash equal.
+        }
+        using Bits = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+        Bits bits;
+        std::memcpy(&bits, &value, sizeof(T));
+        return bits;
+    } else {
+        return static_cast<uint64_t>(value);
+    }
+}
+
+} // namespace detail
+
+// Sum of the column accumulated in R (int64_t or double are the usual choices).
+template <typename R = double>
+R sum(const AnyVector& column) {
+    return column.visit([](const auto* x, size_t n) {
+        R total = R(0);
+        for (size_t i = 0; i < n; ++i) {
+            total += static_cast<R>(x[i]);
+        }
+        return total;
+    });
+}
+
+// Elements whose mask byte is non-zero, in order. The copy is branch-free so selectivity does
+// not cost mispredictions.
+template <typename MaskAllocator>
+AnyVector filter(const AnyVector& column, const Vector<uint8_t, MaskAllocator>& mask) {
+    if (mask.size() != column.size()) {
+        VECTOR_THROW(std::invalid_argument("filter mask size does not match the column"));
+    }
+    AnyVector out(column.type());
+    out.resize_for_overwrite(column.size());
+    size_t kept = column.visit([&](const auto* x, size_t n) {
+        using T = std::remove_const_t<std::remove_pointer_t<decltype(x)>>;
+        T* dst = out.data_as<T>();
+        size_t k = 0;
+        for (size_t i = 0; i < n; ++i) {
+            dst[k] = x[i];
+            k += mask[i] != 0;
+        }
+        return k;
+    });
+    out.resize(kept);
+    return out;
+}
+
+// Elements for which pred(value) is true; pred is called with the concrete T, typically through
+// a generic lambda, and is instantiated once per element type.
+template <typename Pred>
+AnyVector filter_if(const AnyVector& column, Pred&& pred) {
+    AnyVector out(column.type());
+    out.resize_for_overwrite(column.size());
+    size_t kept = column.visit([&](const auto* x, size_t n) {
+        using T = std::remove_const_t<std::remove_pointer_t<decltype(x)>>;
+        T* dst = out.data_as<T>();
+        size_t k = 0;
+        for (size_t i = 0; i < n; ++i) {
+            dst[k] = x[i];
+            k += static_cast<bool>(pred(x[i]));
+        }
+        return k;
+    });
+    out.resize(kept);
+    return out;
+}
+
+// Gathers column[indices[0]], column[indices[1]], ... (e.g. to apply an argsort permutation).
+template <typename IndexAllocator>
+AnyVector take(const AnyVector& column, const Vector<uint32_t, IndexAllocator>& indices) {
+    AnyVector out(column.type());
+    out.resize_for_overwrite(indices.size());
+    column.visit([&](const auto* x, size_t n) {
+        using T = std::remove_const_t<std::remove_pointer_t<decltype(x)>>;
+        T* dst = out.data_as<T>();
+        for (size_t i = 0; i < indices.size(); ++i) {
+            if (indices[i] >= n) {
+                VECTOR_THROW(std::out_of_range("take index out of range"));
+            }
+            dst[i] = x[indices[i]];
+        }
+    });
+    return out;
+}
+
+// Sorts ascending in place; NaNs go last.
+inline void sort(AnyVector& column) {
+    column.visit([](auto* x, size_t n) {
+        using T = std::remove_pointer_t<decltype(x)>;
+        std::sort(x, x + n, detail::any_less<T>);
+    });
+}
+
+// The stable permutation that sorts the column, for reordering sibling columns with take().
+inline Vector<uint32_t> argsort(const AnyVector& column) {
+    if (column.size() > UINT32_MAX) {
+        VECTOR_THROW(std::length_error("argsort supports at most 2^32 - 1 rows"));
+    }
+    Vector<uint32_t> order;
+    order.resize_for_overwrite(column.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    column.visit([&](const auto* x, size_t) {
+        using T = std::remove_const_t<std::remove_pointer_t<decltype(x)>>;
+        std::stable_sort(order.data(), order.data() + order.size(), [x](uint32_t a, uint32_t b) { return detail::any_less<T>(x[a], x[b]); });
+    });
+    return order;
+}
+
+// Hash of the whole column; equals hash(Vector<T>) of the same elements and seed.
+inline uint64_t hash(const AnyVector& column, uint64_t seed = 0) {
+    Hasher hasher(seed);
+    column.visit([&](const auto* x, size_t n) { hash_elements(hasher, x, n); });
+    return hasher.finish();
+}
+
+// One 64-bit hash per element, for hash joins and group-by. Values that compare equal hash
+// equal, including -0.0 and 0.0.
+inline Vector<uint64_t> row_hashes(const AnyVector& column, uint64_t seed = 0) {
+    Vector<uint64_t> out;
+    out.resize_for_overwrite(column.size());
+    column.visit([&](const auto* x, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = detail::hash_mix(detail::any_key_bits(x[i]) ^ seed ^ detail::kHashP0, detail::kHashP1);
+        }
+    });
+    return out;
+}
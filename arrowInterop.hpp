@@ -0,0 +1,268 @@
+#pragma once
+
+#include "customVector.hpp"
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+// Arrow C Data Interface structs, verbatim from the specification. The guard lets this header
+// coexist with arrow/c/abi.h or any other copy of the same definitions.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C" {
+
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+} // extern "C"
+
+#endif // ARROW_C_DATA_INTERFACE
+
+// Vectors whose buffers satisfy Arrow's recommended 64-byte alignment and padding.
+template <typename T>
+using ArrowVector = Vector<T, AlignedAllocator<T, 64>>;
+
+template <typename T> struct ArrowFormat;
+template <> struct ArrowFormat<int8_t> { static constexpr const char* value = "c"; };
+template <> struct ArrowFormat<uint8_t> { static constexpr const char* value = "C"; };
+template <> struct ArrowFormat<int16_t> { static constexpr const char* value = "s"; };
+template <> struct ArrowFormat<uint16_t> { static constexpr const char* value = "S"; };
+template <> struct ArrowFormat<int32_t> { static constexpr const char* value = "i"; };
+template <> struct ArrowFormat<uint32_t> { static constexpr const char* value = "I"; };
+template <> struct ArrowFormat<int64_t> { static constexpr const char* value = "l"; };
+template <> struct ArrowFormat<uint64_t> { static constexpr const char* value = "L"; };
+template <> struct ArrowFormat<float> { static constexpr const char* value = "f"; };
+template <> struct ArrowFormat<double> { static constexpr const char* value = "g"; };
+
+// Variable-length UTF-8 strings in Arrow's layout: int32 offsets (size() + 1 of them) into one
+// contiguous character buffer.
+template <template <typename> class Storage = ArrowVector>
+class BasicStringVector {
+public:
+    BasicStringVector() { offsets_.push_back(0); }
+
+    size_t size() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+    bool empty() const { return size() == 0; }
+
+    void reserve(size_t count, size_t total_chars) {
+        offsets_.reserve(count + 1);
+        chars_.reserve(total_chars);
+    }
+
+    void push_back(std::string_view s) {
+        size_t end = chars_.size() + s.size();
+        if (end > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+            VECTOR_THROW(std::length_error("StringVector exceeds 32-bit offsets"));
+        }
+        if (offsets_.empty()) {
+            offsets_.push_back(0);
+        }
+        size_t old = chars_.size();
+        chars_.resize(end);
+        std::memcpy(chars_.data() + old, s.data(), s.size());
+        offsets_.push_back(static_cast<int32_t>(end));
+    }
+
+    std::string_view operator[](size_t index) const {
+        return std::string_view(chars_.data() + offsets_[index], static_cast<size_t>(offsets_[index + 1] - offsets_[index]));
+    }
+
+    const Storage<int32_t>& offsets() const { return offsets_; }
+    const Storage<char>& chars() const { return chars_; }
+
+private:
+    friend void export_to_arrow(BasicStringVector<ArrowVector>&&, ArrowArray*, ArrowSchema*);
+
+    Storage<int32_t> offsets_;
+    Storage<char> chars_;
+};
+
+using StringVector = BasicStringVector<>;
+
+namespace detail {
+
+inline void release_arrow_schema(ArrowSchema* schema) {
+    schema->release = nullptr;
+}
+
+inline void fill_arrow_schema(ArrowSchema* schema, const char* format) {
+    schema->format = format;
+    schema->name = nullptr;
+    schema->metadata = nullptr;
+    schema->flags = 0;
+    schema->n_children = 0;
+    schema->children = nullptr;
+    schema->dictionary = nullptr;
+    schema->release = &release_arrow_schema;
+    schema->private_data = nullptr;
+}
+
+// Owns the exported storage; the consumer frees it through ArrowArray::release.
+template <typename Payload, size_t Buffers>
+struct ArrowExportHolder {
+    Payload payload;
+    const void* buffers[Buffers];
+
+    static void release(ArrowArray* array) {
+        delete static_cast<ArrowExportHolder*>(array->private_data);
+        array->release = nullptr;
+    }
+};
+
+template <typename Holder>
+void fill_arrow_array(ArrowArray* array, Holder* holder, int64_t length, int64_t n_buffers) {
+    array->length = length;
+    array->null_count = 0;
+    array->offset = 0;
+    array->n_buffers = n_buffers;
+    array->n_children = 0;
+    array->buffers = holder->buffers;
+    array->children = nullptr;
+    array->dictionary = nullptr;
+    array->release = &Holder::release;
+    array->private_data = holder;
+}
+
+inline void check_arrow_import(const ArrowArray* array, const ArrowSchema* schema, const char* format, int64_t n_buffers) {
+    if (array->release == nullptr) {
+        VECTOR_THROW(std::invalid_argument("ArrowArray has already been released"));
+    }
+    if (schema != nullptr && std::strcmp(schema->format, format) != 0) {
+        VECTOR_THROW(std::invalid_argument("Arrow format does not match the requested element type"));
+    }
+    if (array->n_buffers != n_buffers || array->n_children != 0) {
+        VECTOR_THROW(std::invalid_argument("Unexpected Arrow buffer layout"));
+    }
+}
+
+} // namespace detail
+
+// Moves the Vector's buffer into the exported array; no element is copied. The Vector is left
+// empty and the buffer lives until the consumer calls out->release.
+template <typename T, typename Allocator>
+void export_to_arrow(Vector<T, Allocator>&& vec, ArrowArray* out, ArrowSchema* schema) {
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "Only primitive numeric Vectors map to Arrow arrays");
+    using Holder = detail::ArrowExportHolder<Vector<T, Allocator>, 2>;
+    auto* holder = new Holder{std::move(vec), {nullptr, nullptr}};
+    holder->buffers[1] = holder->payload.data();
+    detail::fill_arrow_array(out, holder, static_cast<int64_t>(holder->payload.size()), 2);
+    if (schema != nullptr) {
+        detail::fill_arrow_schema(schema, ArrowFormat<T>::value);
+    }
+}
+
+inline void export_to_arrow(BasicStringVector<ArrowVector>&& strings, ArrowArray* out, ArrowSchema* schema) {
+    using Holder = detail::ArrowExportHolder<BasicStringVector<ArrowVector>, 3>;
+    auto* holder = new Holder{std::move(strings), {nullptr, nullptr, nullptr}};
+    holder->buffers[1] = holder->payload.offsets_.data();
+    holder->buffers[2] = holder->payload.chars_.data();
+    detail::fill_arrow_array(out, holder, static_cast<int64_t>(holder->payload.size()), 3);
+    if (schema != nullptr) {
+        detail::fill_arrow_schema(schema, "u");
+    }
+}
+
+// Read-only column that takes ownership of an imported ArrowArray (the source struct is marked
+// released, per the interface's move semantics) and reads its buffers in place.
+template <typename T>
+class ArrowColumn {
+public:
+    ArrowColumn(ArrowArray* array, const ArrowSchema* schema) {
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "Only primitive numeric columns are supported");
+        detail::check_arrow_import(array, schema, ArrowFormat<T>::value, 2);
+        array_ = *array;
+        array->release = nullptr;
+    }
+
+    ArrowColumn(const ArrowColumn&) = delete;
+    ArrowColumn& operator=(const ArrowColumn&) = delete;
+    ArrowColumn(ArrowColumn&& other) noexcept : array_(other.array_) { other.array_.release = nullptr; }
+
+    ~ArrowColumn() {
+        if (array_.release != nullptr) {
+            array_.release(&array_);
+        }
+    }
+
+    size_t size() const { return static_cast<size_t>(array_.length); }
+    bool empty() const { return array_.length == 0; }
+    size_t null_count() const { return static_cast<size_t>(array_.null_count); }
+
+    const T* data() const noexcept { return static_cast<const T*>(array_.buffers[1]) + array_.offset; }
+    const T& operator[](size_t index) const { return data()[index]; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size(); }
+
+    bool is_valid(size_t index) const {
+        const auto* validity = static_cast<const uint8_t*>(array_.buffers[0]);
+        if (validity == nullptr) {
+            return true;
+        }
+        size_t bit = index + static_cast<size_t>(array_.offset);
+        return (validity[bit / 8] >> (bit % 8)) & 1;
+    }
+
+    Vector<T> to_vector() const { return Vector<T>(begin(), end()); }
+
+private:
+    ArrowArray array_;
+};
+
+class ArrowStringColumn {
+public:
+    ArrowStringColumn(ArrowArray* array, const ArrowSchema* schema) {
+        detail::check_arrow_import(array, schema, "u", 3);
+        array_ = *array;
+        array->release = nullptr;
+    }
+
+    ArrowStringColumn(const ArrowStringColumn&) = delete;
+    ArrowStringColumn& operator=(const ArrowStringColumn&) = delete;
+    ArrowStringColumn(ArrowStringColumn&& other) noexcept : array_(other.array_) { other.array_.release = nullptr; }
+
+    ~ArrowStringColumn() {
+        if (array_.release != nullptr) {
+            array_.release(&array_);
+        }
+    }
+
+    size_t size() const { return static_cast<size_t>(array_.length); }
+    bool empty() const { return array_.length == 0; }
+
+    std::string_view operator[](size_t index) const {
+        const int32_t* offsets = static_cast<const int32_t*>(array_.buffers[1]) + array_.offset;
+        const char* chars = static_cast<const char*>(array_.buffers[2]);
+        return std::string_view(chars + offsets[index], static_cast<size_t>(offsets[index + 1] - offsets[index]));
+    }
+
+private:
+    ArrowArray array_;
+};
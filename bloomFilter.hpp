@@ -0,0 +1,401 @@
+#pragma once
+
+#include "customVector.hpp"
+#include "simd.hpp"
+#include "vectorHash.hpp"
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+namespace detail {
+
+// Split-block layout: each key selects one 512-bit block (one cache line of eight words) and
+// sets one bit in every word of it, so an insert or probe touches a single cache line.
+constexpr size_t kBloomBlockWords = 8;
+constexpr uint32_t kBloomSalts[kBloomBlockWords] = {
+    0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+    0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u,
+};
+
+inline uint64_t bloom_key_hash(uint64_t key) {
+    return hash_mix(key ^ kHashP0, kHashP1);
+}
+
+inline size_t bloom_block(uint64_t h, size_t blocks) {
+    return static_cast<size_t>(((h >> 32) * static_cast<uint64_t>(blocks)) >> 32);
+}
+
+// Bit index (0..63) this key uses inside word i of its block.
+inline uint32_t bloom_bit(uint64_t h, size_t i) {
+    return (static_cast<uint32_t>(h) * kBloomSalts[i]) >> 26;
+}
+
+inline void bloom_insert_scalar(uint64_t* block, uint64_t h) {
+    for (size_t i = 0; i < kBloomBlockWords; ++i) {
+        block[i] |= uint64_t(1) << bloom_bit(h, i);
+    }
+}
+
+inline bool bloom_contains_scalar(const uint64_t* block, uint64_t h) {
+    for (size_t i = 0; i < kBloomBlockWords; ++i) {
+        if ((block[i] & (uint64_t(1) << bloom_bit(h, i))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#if VECTOR_DISPATCH_X86
+VECTOR_TARGET_AVX2 inline __m256i bloom_bits(uint64_t h) {
+    __m256i salts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kBloomSalts));
+    return _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(h)), salts), 26);
+}
+
+VECTOR_TARGET_AVX2 inline void bloom_masks(uint64_t h, __m256i& lo, __m256i& hi) {
+    __m256i bits = bloom_bits(h);
+    __m256i one = _mm256_set1_epi64x(1);
+    lo = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(bits)));
+    hi = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(bits, 1)));
+}
+
+// Blocks are cache-line aligned, so the aligned loads and stores below are safe.
+VECTOR_TARGET_AVX2 inline void bloom_insert_avx2(uint64_t* block, uint64_t h) {
+    __m256i lo, hi;
+    bloom_masks(h, lo, hi);
+    __m256i* p = reinterpret_cast<__m256i*>(block);
+    _mm256_store_si256(p, _mm256_or_si256(_mm256_load_si256(p), lo));
+    _mm256_store_si256(p + 1, _mm256_or_si256(_mm256_load_si256(p + 1), hi));
+}
+
+VECTOR_TARGET_AVX2 inline bool bloom_contains_avx2(const uint64_t* block, uint64_t h) {
+    __m256i lo, hi;
+    bloom_masks(h, lo, hi);
+    const __m256i* p = reinterpret_cast<const __m256i*>(block);
+    return _mm256_testc_si256(_mm256_load_si256(p), lo) && _mm256_testc_si256(_mm256_load_si256(p + 1), hi);
+}
+
+// The whole block fits one register: eight 32-bit bit indices widen to eight 64-bit masks.
+VECTOR_TARGET_AVX512 inline __m512i bloom_mask512(uint64_t h) {
+    return _mm512_sllv_epi64(_mm512_set1_epi64(1), _mm512_cvtepu32_epi64(bloom_bits(h)));
+}
+
+VECTOR_TARGET_AVX512 inline void bloom_insert_avx512(uint64_t* block, uint64_t h) {
+    _mm512_store_si512(block, _mm512_or_si512(_mm512_load_si512(block), bloom_mask512(h)));
+}
+
+VECTOR_TARGET_AVX512 inline bool bloom_contains_avx512(const uint64_t* block, uint64_t h) {
+    __m512i mask = bloom_mask512(h);
+    __m512i missing = _mm512_andnot_si512(_mm512_load_si512(block), mask);
+    return _mm512_test_epi64_mask(missing, missing) == 0;
+}
+#endif
+
+inline void bloom_insert(uint64_t* block, uint64_t h) {
+#if VECTOR_DISPATCH_X86
+    static const auto kernel = select_kernel(&bloom_insert_scalar, nullptr, &bloom_insert_avx2, &bloom_insert_avx512);
+    kernel(block, h);
+#else
+    bloom_insert_scalar(block, h);
+#endif
+}
+
+inline bool bloom_contains(const uint64_t* block, uint64_t h) {
+#if VECTOR_DISPATCH_X86
+    static const auto kernel = select_kernel(&bloom_contains_scalar, nullptr, &bloom_contains_avx2, &bloom_contains_avx512);
+    return kernel(block, h);
+#else
+    return bloom_contains_scalar(block, h);
+#endif
+}
+
+inline size_t bloom_blocks_for(size_t expected_items, double bits_per_item) {
+    double bits = static_cast<double>(expected_items) * bits_per_item;
+    size_t blocks = static_cast<size_t>(bits / (64.0 * kBloomBlockWords)) + 1;
+    return blocks;
+}
+
+inline void bloom_write_header(Vector<uint8_t>& out, uint32_t magic, uint64_t blocks) {
+    out.resize(12);
+    std::memcpy(out.data(), &magic, sizeof(magic));
+    std::memcpy(out.data() + 4, &blocks, sizeof(blocks));
+}
+
+inline uint64_t bloom_read_header(const uint8_t* data, size_t n, uint32_t magic) {
+    uint32_t found = 0;
+    uint64_t blocks = 0;
+    if (n >= 12) {
+        std::memcpy(&found, data, sizeof(found));
+        std::memcpy(&blocks, data + 4, sizeof(blocks));
+    }
+    if (n < 12 || found != magic || blocks == 0 || (n - 12) / (kBloomBlockWords * 8) != blocks
+        || (n - 12) % (kBloomBlockWords * 8) != 0) {
+        VECTOR_THROW(std::invalid_argument("Invalid serialized Bloom filter"));
+    }
+    return blocks;
+}
+
+constexpr size_t kBloomPrefetchDistance = 8;
+
+} // namespace detail
+
+class BlockedBloomFilter {
+public:
+    using Storage = Vector<uint64_t, AlignedAllocator<uint64_t, 64>>;
+    static constexpr uint32_t kMagic = 0x31464242u;
+
+    explicit BlockedBloomFilter(size_t expected_items, double bits_per_item = 10.0)
+        : words_(detail::bloom_blocks_for(expected_items, bits_per_item) * detail::kBloomBlockWords, 0) {}
+
+    size_t block_count() const { return words_.size() / detail::kBloomBlockWords; }
+    size_t size_bytes() const { return words_.size() * sizeof(uint64_t); }
+    const uint64_t* data() const noexcept { return words_.data(); }
+
+    void insert(uint64_t key) { insert_hash(detail::bloom_key_hash(key)); }
+    bool contains(uint64_t key) const { return contains_hash(detail::bloom_key_hash(key)); }
+
+    template <typename T, typename = std::enable_if_t<!std::is_integral_v<T>>>
+    void insert(const T& key) { insert_hash(detail::bloom_key_hash(std::hash<T>{}(key))); }
+    template <typename T, typename = std::enable_if_t<!std::is_integral_v<T>>>
+    bool contains(const T& key) const { return contains_hash(detail::bloom_key_hash(std::hash<T>{}(key))); }
+
+    void insert_hash(uint64_t h) {
+        detail::bloom_insert(words_.data() + detail::bloom_block(h, block_count()) * detail::kBloomBlockWords, h);
+    }
+
+    bool contains_hash(uint64_t h) const {
+        return detail::bloom_contains(words_.data() + detail::bloom_block(h, block_count()) * detail::kBloomBlockWords, h);
+    }
+
+    // Batch forms hash a window of keys ahead and prefetch their blocks, so the cache misses
+    // of independent keys overlap instead of being taken one at a time.
+    void insert_batch(const uint64_t* keys, size_t n) {
+        uint64_t hashes[detail::kBloomPrefetchDistance];
+        for (size_t i = 0; i < n; i += detail::kBloomPrefetchDistance) {
+            size_t count = std::min(detail::kBloomPrefetchDistance, n - i);
+            prefetch_window(keys + i, count, hashes);
+            for (size_t j = 0; j < count; ++j) {
+                insert_hash(hashes[j]);
+            }
+        }
+    }
+
+    template <typename Allocator>
+    void insert_batch(const Vector<uint64_t, Allocator>& keys) { insert_batch(keys.data(), keys.size()); }
+
+    size_t contains_batch(const uint64_t* keys, size_t n, uint8_t* out) const {
+        uint64_t hashes[detail::kBloomPrefetchDistance];
+        size_t hits = 0;
+        for (size_t i = 0; i < n; i += detail::kBloomPrefetchDistance) {
+            size_t count = std::min(detail::kBloomPrefetchDistance, n - i);
+            prefetch_window(keys + i, count, hashes);
+            for (size_t j = 0; j < count; ++j) {
+                out[i + j] = contains_hash(hashes[j]) ? 1 : 0;
+                hits += out[i + j];
+            }
+        }
+        return hits;
+    }
+
+    template <typename Allocator>
+    Vector<uint8_t> contains_batch(const Vector<uint64_t, Allocator>& keys) const {
+        Vector<uint8_t> out(keys.size());
+        contains_batch(keys.data(), keys.size(), out.data());
+        return out;
+    }
+
+    void merge(const BlockedBloomFilter& other) {
+        if (other.words_.size() != words_.size()) {
+            VECTOR_THROW(std::invalid_argument("Cannot merge Bloom filters of different sizes"));
+        }
+        uint64_t* dst = words_.data();
+        const uint64_t* src = other.words_.data();
+        for (size_t i = 0; i < words_.size(); ++i) {
+            dst[i] |= src[i];
+        }
+    }
+
+    void clear() { std::fill(words_.data(), words_.data() + words_.size(), uint64_t(0)); }
+
+    Vector<uint8_t> serialize() const {
+        Vector<uint8_t> out;
+        detail::bloom_write_header(out, kMagic, block_count());
+        out.resize(12 + size_bytes());
+        std::memcpy(out.data() + 12, words_.data(), size_bytes());
+        return out;
+    }
+
+    static BlockedBloomFilter deserialize(const uint8_t* data, size_t n) {
+        uint64_t blocks = detail::bloom_read_header(data, n, kMagic);
+        BlockedBloomFilter filter;
+        filter.words_.resize(blocks * detail::kBloomBlockWords, 0);
+        std::memcpy(filter.words_.data(), data + 12, filter.size_bytes());
+        return filter;
+    }
+
+private:
+    Storage words_;
+
+    BlockedBloomFilter() = default;
+
+    void prefetch_window(const uint64_t* keys, size_t count, uint64_t* hashes) const {
+        for (size_t j = 0; j < count; ++j) {
+            hashes[j] = detail::bloom_key_hash(keys[j]);
+#if defined(__GNUC__)
+            __builtin_prefetch(words_.data() + detail::bloom_block(hashes[j], block_count()) * detail::kBloomBlockWords);
+#endif
+        }
+    }
+};
+
+// Same block layout with 4-bit counters instead of bits: each word holds sixteen counters and a
+// key increments one counter per word. Counters saturate at 15 and are then never decremented.
+class CountingBloomFilter {
+public:
+    using Storage = Vector<uint64_t, AlignedAllocator<uint64_t, 64>>;
+    static constexpr uint32_t kMagic = 0x31464243u;
+    static constexpr uint64_t kCounterMax = 15;
+
+    explicit CountingBloomFilter(size_t expected_items, double counters_per_item = 10.0)
+        : words_(detail::bloom_blocks_for(expected_items, counters_per_item * 4.0) * detail::kBloomBlockWords, 0) {}
+
+    size_t block_count() const { return words_.size() / detail::kBloomBlockWords; }
+    size_t size_bytes() const { return words_.size() * sizeof(uint64_t); }
+    const uint64_t* data() const noexcept { return words_.data(); }
+
+    void insert(uint64_t key) { insert_hash(detail::bloom_key_hash(key)); }
+
+    // Removing a key that was never inserted corrupts the filter, as with any counting filter.
+    void erase(uint64_t key) {
+        uint64_t h = detail::bloom_key_hash(key);
+        uint64_t* block = block_for(h);
+        for (size_t i = 0; i < detail::kBloomBlockWords; ++i) {
+            unsigned shift = counter_shift(h, i);
+            uint64_t counter = (block[i] >> shift) & kCounterMax;
+            if (counter != 0 && counter != kCounterMax) {
+                block[i] -= uint64_t(1) << shift;
+            }
+        }
+    }
+
+    bool contains(uint64_t key) const { return contains_hash(detail::bloom_key_hash(key)); }
+
+    // Batch forms prefetch a window of blocks ahead, as in BlockedBloomFilter.
+    void insert_batch(const uint64_t* keys, size_t n) {
+        uint64_t hashes[detail::kBloomPrefetchDistance];
+        for (size_t i = 0; i < n; i += detail::kBloomPrefetchDistance) {
+            size_t count = std::min(detail::kBloomPrefetchDistance, n - i);
+            prefetch_window(keys + i, count, hashes);
+            for (size_t j = 0; j < count; ++j) {
+                insert_hash(hashes[j]);
+            }
+        }
+    }
+
+    size_t contains_batch(const uint64_t* keys, size_t n, uint8_t* out) const {
+        uint64_t hashes[detail::kBloomPrefetchDistance];
+        size_t hits = 0;
+        for (size_t i = 0; i < n; i += detail::kBloomPrefetchDistance) {
+            size_t count = std::min(detail::kBloomPrefetchDistance, n - i);
+            prefetch_window(keys + i, count, hashes);
+            for (size_t j = 0; j < count; ++j) {
+                out[i + j] = contains_hash(hashes[j]) ? 1 : 0;
+                hits += out[i + j];
+            }
+        }
+        return hits;
+    }
+
+    // Saturating per-counter addition, done nibble-parallel within each word.
+    void merge(const CountingBloomFilter& other) {
+        if (other.words_.size() != words_.size()) {
+            VECTOR_THROW(std::invalid_argument("Cannot merge Bloom filters of different sizes"));
+        }
+        constexpr uint64_t low3 = 0x7777777777777777ull;
+        constexpr uint64_t high = 0x8888888888888888ull;
+        for (size_t i = 0; i < words_.size(); ++i) {
+            uint64_t a = words_[i];
+            uint64_t b = other.words_[i];
+            uint64_t partial = (a & low3) + (b & low3);
+            uint64_t sum = partial ^ ((a ^ b) & high);
+            uint64_t carry = ((a & b) | ((a | b) & ~sum)) & high;
+            uint64_t overflow = (carry >> 3) * kCounterMax;
+            words_[i] = sum | overflow;
+        }
+    }
+
+    BlockedBloomFilter to_bloom_filter() const {
+        Vector<uint8_t> bytes;
+        detail::bloom_write_header(bytes, BlockedBloomFilter::kMagic, block_count());
+        bytes.resize(12 + size_bytes());
+        uint64_t* bits = reinterpret_cast<uint64_t*>(bytes.data() + 12);
+        for (size_t w = 0; w < words_.size(); ++w) {
+            uint64_t out = 0;
+            for (unsigned c = 0; c < 16; ++c) {
+                uint64_t counter = (words_[w] >> (4 * c)) & kCounterMax;
+                if (counter != 0) {
+                    out |= uint64_t(0xF) << (4 * c);
+                }
+            }
+            std::memcpy(bits + w, &out, sizeof(out));
+        }
+        return BlockedBloomFilter::deserialize(bytes.data(), bytes.size());
+    }
+
+    Vector<uint8_t> serialize() const {
+        Vector<uint8_t> out;
+        detail::bloom_write_header(out, kMagic, block_count());
+        out.resize(12 + size_bytes());
+        std::memcpy(out.data() + 12, words_.data(), size_bytes());
+        return out;
+    }
+
+    static CountingBloomFilter deserialize(const uint8_t* data, size_t n) {
+        uint64_t blocks = detail::bloom_read_header(data, n, kMagic);
+        CountingBloomFilter filter;
+        filter.words_.resize(blocks * detail::kBloomBlockWords, 0);
+        std::memcpy(filter.words_.data(), data + 12, filter.size_bytes());
+        return filter;
+    }
+
+private:
+    Storage words_;
+
+    CountingBloomFilter() = default;
+
+    uint64_t* block_for(uint64_t h) {
+        return words_.data() + detail::bloom_block(h, block_count()) * detail::kBloomBlockWords;
+    }
+
+    void insert_hash(uint64_t h) {
+        uint64_t* block = block_for(h);
+        for (size_t i = 0; i < detail::kBloomBlockWords; ++i) {
+            unsigned shift = counter_shift(h, i);
+            if (((block[i] >> shift) & kCounterMax) != kCounterMax) {
+                block[i] += uint64_t(1) << shift;
+            }
+        }
+    }
+
+    bool contains_hash(uint64_t h) const {
+        const uint64_t* block = words_.data() + detail::bloom_block(h, block_count()) * detail::kBloomBlockWords;
+        for (size_t i = 0; i < detail::kBloomBlockWords; ++i) {
+            if (((block[i] >> counter_shift(h, i)) & kCounterMax) == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void prefetch_window(const uint64_t* keys, size_t count, uint64_t* hashes) const {
+        for (size_t j = 0; j < count; ++j) {
+            hashes[j] = detail::bloom_key_hash(keys[j]);
+#if defined(__GNUC__)
+            __builtin_prefetch(words_.data() + detail::bloom_block(hashes[j], block_count()) * detail::kBloomBlockWords);
+#endif
+        }
+    }
+
+    static unsigned counter_shift(uint64_t h, size_t i) {
+        return 4 * (detail::bloom_bit(h, i) >> 2);
+    }
+};
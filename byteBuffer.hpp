@@ -0,0 +1,326 @@
+#pragma once
+
+#include "customVector.hpp"
+#include "simd.hpp"
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+inline uint64_t zigzag_encode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t zigzag_decode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+constexpr size_t kMaxVarintBytes = 10;
+
+// Writes LEB128 varints and little-endian values through a raw pointer with no capacity checks.
+// Obtain one from ByteBuffer::begin_write(max_bytes) and hand it back to end_write().
+class UncheckedWriter {
+public:
+    explicit UncheckedWriter(uint8_t* pos) : pos_(pos) {}
+
+    uint8_t* position() const { return pos_; }
+
+    void put_u8(uint8_t value) { *pos_++ = value; }
+
+    template <typename T>
+    void put_le(T value) {
+        static_assert(std::is_arithmetic_v<T>, "put_le requires an arithmetic type");
+        using U = std::conditional_t<sizeof(T) == 1, uint8_t, std::conditional_t<sizeof(T) == 2, uint16_t,
+                  std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+        U bits;
+        std::memcpy(&bits, &value, sizeof(T));
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            pos_[i] = static_cast<uint8_t>(bits >> (8 * i));
+        }
+        pos_ += sizeof(T);
+    }
+
+    void put_varint(uint64_t value) {
+        while (value >= 0x80) {
+            *pos_++ = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        *pos_++ = static_cast<uint8_t>(value);
+    }
+
+    void put_svarint(int64_t value) { put_varint(zigzag_encode(value)); }
+
+    void put_bytes(const void* data, size_t n) {
+        if (n > 0) {
+            std::memcpy(pos_, data, n);
+            pos_ += n;
+        }
+    }
+
+private:
+    uint8_t* pos_;
+};
+
+class ByteBuffer {
+public:
+    ByteBuffer() = default;
+    explicit ByteBuffer(size_t capacity) { bytes_.reserve(capacity); }
+
+    size_t size() const { return bytes_.size(); }
+    size_t capacity() const { return bytes_.capacity(); }
+    bool empty() const { return bytes_.empty(); }
+    void reserve(size_t n) { bytes_.reserve(n); }
+    void clear() { bytes_.clear(); }
+
+    uint8_t* data() noexcept { return bytes_.data(); }
+    const uint8_t* data() const noexcept { return bytes_.data(); }
+    const Vector<uint8_t>& bytes() const { return bytes_; }
+    Vector<uint8_t> take() { return std::move(bytes_); }
+
+    // Grows the buffer by up to max_bytes in one capacity check; everything written through the
+    // returned writer is kept by end_write(), the unused tail is dropped.
+    UncheckedWriter begin_write(size_t max_bytes) {
+        size_t old = bytes_.size();
+        bytes_.resize_for_overwrite(old + max_bytes);
+        return UncheckedWriter(bytes_.data() + old);
+    }
+
+    void end_write(const UncheckedWriter& writer) {
+        bytes_.resize(static_cast<size_t>(writer.position() - bytes_.data()));
+    }
+
+    void append_bytes(const void* data, size_t n) {
+        UncheckedWriter w = begin_write(n);
+        w.put_bytes(data, n);
+        end_write(w);
+    }
+
+    void put_u8(uint8_t value) {
+        UncheckedWriter w = begin_write(1);
+        w.put_u8(value);
+        end_write(w);
+    }
+
+    template <typename T>
+    void put_le(T value) {
+        UncheckedWriter w = begin_write(sizeof(T));
+        w.put_le(value);
+        end_write(w);
+    }
+
+    void put_u16(uint16_t value) { put_le(value); }
+    void put_u32(uint32_t value) { put_le(value); }
+    void put_u64(uint64_t value) { put_le(value); }
+    void put_f32(float value) { put_le(value); }
+    void put_f64(double value) { put_le(value); }
+
+    void put_varint(uint64_t value) {
+        UncheckedWriter w = begin_write(kMaxVarintBytes);
+        w.put_varint(value);
+        end_write(w);
+    }
+
+    void put_svarint(int64_t value) { put_varint(zigzag_encode(value)); }
+
+    void put_varints(const uint64_t* values, size_t n) {
+        UncheckedWriter w = begin_write(n * kMaxVarintBytes);
+        for (size_t i = 0; i < n; ++i) {
+            w.put_varint(values[i]);
+        }
+        end_write(w);
+    }
+
+    void put_svarints(const int64_t* values, size_t n) {
+        UncheckedWriter w = begin_write(n * kMaxVarintBytes);
+        for (size_t i = 0; i < n; ++i) {
+            w.put_svarint(values[i]);
+        }
+        end_write(w);
+    }
+
+private:
+    Vector<uint8_t> bytes_;
+};
+
+namespace detail {
+
+[[noreturn]] inline void throw_truncated() {
+    VECTOR_THROW(std::out_of_range("ByteReader: truncated input"));
+}
+
+[[noreturn]] inline void throw_malformed_varint() {
+    VECTOR_THROW(std::invalid_argument("ByteReader: malformed varint"));
+}
+
+inline uint64_t assemble_varint(const uint8_t* p, size_t len) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < len; ++i) {
+        value |= static_cast<uint64_t>(p[i] & 0x7F) << (7 * i);
+    }
+    return value;
+}
+
+// Decodes up to count varints from [p, end) into out. With SSE2, 16 bytes are classified at a
+// time: a block of sixteen one-byte varints is widened directly, otherwise the terminator mask
+// gives every varint boundary in the block without a per-byte branch. Returns bytes consumed;
+// *decoded receives the number of values produced (less than count only if input runs out).
+inline size_t decode_varints(const uint8_t* p, const uint8_t* end, uint64_t* out, size_t count, size_t* decoded) {
+    const uint8_t* start = p;
+    size_t done = 0;
+#if defined(VECTOR_SIMD_SSE2)
+    while (done < count && end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        uint32_t terminators = ~static_cast<uint32_t>(_mm_movemask_epi8(chunk)) & 0xFFFFu;
+        if (terminators == 0xFFFFu && count - done >= 16) {
+            for (size_t i = 0; i < 16; ++i) {
+                out[done + i] = p[i];
+            }
+            done += 16;
+            p += 16;
+            continue;
+        }
+        size_t consumed = 0;
+        while (terminators != 0 && done < count) {
+            size_t last = static_cast<size_t>(__builtin_ctz(terminators));
+            size_t len = last + 1 - consumed;
+            if (len > kMaxVarintBytes) {
+                throw_malformed_varint();
+            }
+            out[done++] = assemble_varint(p + consumed, len);
+            consumed = last + 1;
+            terminators &= terminators - 1;
+        }
+        if (consumed == 0) {
+            throw_malformed_varint();
+        }
+        p += consumed;
+    }
+#endif
+    while (done < count && p < end) {
+        size_t len = 0;
+        while (p + len < end && (p[len] & 0x80) != 0) {
+            ++len;
+        }
+        if (p + len == end) {
+            break;
+        }
+        ++len;
+        if (len > kMaxVarintBytes) {
+            throw_malformed_varint();
+        }
+        out[done++] = assemble_varint(p, len);
+        p += len;
+    }
+    *decoded = done;
+    return static_cast<size_t>(p - start);
+}
+
+} // namespace detail
+
+enum class Bounds { Checked, Unchecked };
+
+// Sequential little-endian / varint reader. The Checked form throws std::out_of_range on
+// truncated input and std::invalid_argument on malformed varints; the Unchecked form trusts its
+// input and compiles the bounds tests out.
+template <Bounds Mode = Bounds::Checked>
+class BasicByteReader {
+public:
+    BasicByteReader(const uint8_t* data, size_t n) : pos_(data), end_(data + n) {}
+    explicit BasicByteReader(const Vector<uint8_t>& bytes) : BasicByteReader(bytes.data(), bytes.size()) {}
+    explicit BasicByteReader(const ByteBuffer& buffer) : BasicByteReader(buffer.data(), buffer.size()) {}
+
+    size_t remaining() const { return static_cast<size_t>(end_ - pos_); }
+    bool at_end() const { return pos_ == end_; }
+    const uint8_t* position() const { return pos_; }
+
+    uint8_t read_u8() {
+        require(1);
+        return *pos_++;
+    }
+
+    template <typename T>
+    T read_le() {
+        static_assert(std::is_arithmetic_v<T>, "read_le requires an arithmetic type");
+        using U = std::conditional_t<sizeof(T) == 1, uint8_t, std::conditional_t<sizeof(T) == 2, uint16_t,
+                  std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+        require(sizeof(T));
+        U bits = 0;
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            bits |= static_cast<U>(static_cast<U>(pos_[i]) << (8 * i));
+        }
+        pos_ += sizeof(T);
+        T value;
+        std::memcpy(&value, &bits, sizeof(T));
+        return value;
+    }
+
+    uint16_t read_u16() { return read_le<uint16_t>(); }
+    uint32_t read_u32() { return read_le<uint32_t>(); }
+    uint64_t read_u64() { return read_le<uint64_t>(); }
+    float read_f32() { return read_le<float>(); }
+    double read_f64() { return read_le<double>(); }
+
+    uint64_t read_varint() {
+        uint64_t value = 0;
+        for (size_t i = 0; i < kMaxVarintBytes; ++i) {
+            require(1);
+            uint8_t byte = *pos_++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        if constexpr (Mode == Bounds::Checked) {
+            detail::throw_malformed_varint();
+        }
+        return value;
+    }
+
+    int64_t read_svarint() { return zigzag_decode(read_varint()); }
+
+    void read_varints(uint64_t* out, size_t count) {
+        size_t decoded = 0;
+        pos_ += detail::decode_varints(pos_, end_, out, count, &decoded);
+        if constexpr (Mode == Bounds::Checked) {
+            if (decoded != count) {
+                detail::throw_truncated();
+            }
+        }
+    }
+
+    void read_svarints(int64_t* out, size_t count) {
+        static_assert(sizeof(int64_t) == sizeof(uint64_t), "");
+        uint64_t* raw = reinterpret_cast<uint64_t*>(out);
+        read_varints(raw, count);
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = zigzag_decode(raw[i]);
+        }
+    }
+
+    void read_bytes(void* out, size_t n) {
+        require(n);
+        if (n > 0) {
+            std::memcpy(out, pos_, n);
+            pos_ += n;
+        }
+    }
+
+    void skip(size_t n) {
+        require(n);
+        pos_ += n;
+    }
+
+private:
+    const uint8_t* pos_;
+    const uint8_t* end_;
+
+    void require(size_t n) const {
+        if constexpr (Mode == Bounds::Checked) {
+            if (static_cast<size_t>(end_ - pos_) < n) {
+                detail::throw_truncated();
+            }
+        }
+    }
+};
+
+using ByteReader = BasicByteReader<Bounds::Checked>;
+using UncheckedByteReader = BasicByteReader<Bounds::Unchecked>;
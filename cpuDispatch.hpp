@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+
+// Runtime CPU dispatch for the SIMD kernels. Every kernel is compiled for each instruction-set
+// level it supports (using per-function target attributes, so the translation unit itself needs
+// no -m flags); the best level the running CPU supports is chosen once, on first use, through a
+// function pointer. One binary therefore runs AVX-512 code where available and the scalar code
+// on machines without it.
+//
+// Setting VECTOR_CPU_LEVEL=scalar|sse4.2|avx2|avx512 in the environment lowers the level used,
+// for testing the fallbacks; it is never raised above what the CPU supports.
+
+enum class CpuLevel : int { Scalar = 0, SSE42 = 1, AVX2 = 2, AVX512 = 3 };
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define VECTOR_DISPATCH_X86 1
+#include <cpuid.h>
+// GCC 12's AVX-512 intrinsics read a deliberately undefined register, which -Wuninitialized
+// reports at every inlining site when the translation unit is not built with -mavx512f.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#define VECTOR_TARGET_SSE42 __attribute__((target("sse4.2,popcnt")))
+#define VECTOR_TARGET_AVX2 __attribute__((target("avx2,fma,f16c,bmi,bmi2,popcnt")))
+#define VECTOR_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512vl,avx512dq,avx2,fma,f16c,bmi,bmi2,popcnt")))
+#else
+#define VECTOR_DISPATCH_X86 0
+#endif
+
+inline const char* cpu_level_name(CpuLevel level) {
+    switch (level) {
+    case CpuLevel::Scalar: return "scalar";
+    case CpuLevel::SSE42: return "sse4.2";
+    case CpuLevel::AVX2: return "avx2";
+    case CpuLevel::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+namespace detail {
+
+// The AVX2 level also requires FMA and F16C, and AVX-512 means F+BW+VL+DQ; the compiler's CPU
+// model already checks that the OS saves the wider register state.
+inline CpuLevel detect_cpu_level() {
+#if VECTOR_DISPATCH_X86
+    __builtin_cpu_init();
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    bool f16c = __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_F16C) != 0;
+    bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && f16c
+                && __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2");
+    if (avx2 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+        && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512dq")) {
+        return CpuLevel::AVX512;
+    }
+    if (avx2) {
+        return CpuLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) {
+        return CpuLevel::SSE42;
+    }
+#endif
+    return CpuLevel::Scalar;
+}
+
+inline CpuLevel resolve_cpu_level() {
+    CpuLevel level = detect_cpu_level();
+    const char* forced = std::getenv("VECTOR_CPU_LEVEL");
+    if (forced == nullptr) {
+        return level;
+    }
+    for (int i = 0; i <= static_cast<int>(CpuLevel::AVX512); ++i) {
+        CpuLevel candidate = static_cast<CpuLevel>(i);
+        if (std::strcmp(forced, cpu_level_name(candidate)) == 0) {
+            return candidate < level ? candidate : level;
+        }
+    }
+    return level;
+}
+
+// Keeps the optional slots of select_kernel() out of deduction so they accept nullptr.
+template <typename Fn>
+struct KernelSlot {
+    using type = Fn*;
+};
+
+} // namespace detail
+
+// The level kernels dispatch on, detected on first call and fixed afterwards.
+inline CpuLevel cpu_level() {
+    static const CpuLevel level = detail::resolve_cpu_level();
+    return level;
+}
+
+// Returns the implementation for the highest level not above cpu_level(); a null entry means the
+// kernel has no version for that level and the next lower one is used. Call sites keep the result
+// in a function-local static so selection happens once:
+//   static const auto kernel = select_kernel(scalar_fn, nullptr, avx2_fn, avx512_fn);
+template <typename Fn>
+Fn* select_kernel(Fn* scalar, typename detail::KernelSlot<Fn>::type sse42, typename detail::KernelSlot<Fn>::type avx2,
+                  typename detail::KernelSlot<Fn>::type avx512) {
+    Fn* const table[] = {scalar, sse42, avx2, avx512};
+    for (int i = static_cast<int>(cpu_level()); i > 0; --i) {
+        if (table[i] != nullptr) {
+            return table[i];
+        }
+    }
+    return scalar;
+}
@@ -1,4 +1,7 @@
+#pragma once
+
 #include <cstddef>
+#include <cstdlib>
 #include <stdexcept>
 #include <algorithm>
 #include <iterator>
@@ -7,6 +10,72 @@
 #include <utility>
 #include <initializer_list>
 #include <iostream>
+#include <new>
+#include <type_traits>
+
+// Vector and SimpleAllocator are usable in constant expressions when the compiler supports C++20
+// transient constexpr allocation; under C++17 the qualifier expands to nothing.
+#if defined(__cpp_constexpr_dynamic_alloc) && __cpp_constexpr_dynamic_alloc >= 201907L
+#define VECTOR_HAS_CONSTEXPR_ALLOCATION 1
+#define VECTOR_CONSTEXPR constexpr
+#else
+#define VECTOR_HAS_CONSTEXPR_ALLOCATION 0
+#define VECTOR_CONSTEXPR
+#endif
+
+// Error reporting that also compiles under -fno-exceptions. Without exceptions VECTOR_THROW
+// aborts, the VECTOR_TRY block always runs and its VECTOR_CATCH_ALL handler never does;
+// code that must keep running after a failure uses the try_* members, which return a
+// VectorStatus instead.
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+#define VECTOR_EXCEPTIONS 1
+#define VECTOR_THROW(exception) throw exception
+#define VECTOR_TRY try
+#define VECTOR_CATCH_ALL catch (...)
+#define VECTOR_RETHROW throw
+#else
+#define VECTOR_EXCEPTIONS 0
+#define VECTOR_THROW(exception) std::abort()
+#define VECTOR_TRY if (true)
+#define VECTOR_CATCH_ALL else
+#define VECTOR_RETHROW ((void)0)
+#endif
+
+enum class VectorErrc { ok = 0, out_of_memory, length_error };
+
+class [[nodiscard]] VectorStatus {
+public:
+    constexpr VectorStatus(VectorErrc error = VectorErrc::ok) noexcept : error_(error) {}
+
+    constexpr bool ok() const noexcept { return error_ == VectorErrc::ok; }
+    constexpr explicit operator bool() const noexcept { return ok(); }
+    constexpr VectorErrc error() const noexcept { return error_; }
+
+    const char* message() const noexcept {
+        switch (error_) {
+        case VectorErrc::ok: return "ok";
+        case VectorErrc::out_of_memory: return "out of memory";
+        case VectorErrc::length_error: return "requested size exceeds max_size()";
+        }
+        return "unknown error";
+    }
+
+private:
+    VectorErrc error_;
+};
+
+namespace detail {
+
+// Allocators may provide allocate_nothrow(n), returning nullptr on failure; the try_* members
+// of Vector use it when present so they never throw from allocation.
+template <typename Allocator, typename = void>
+struct has_allocate_nothrow : std::false_type {};
+
+template <typename Allocator>
+struct has_allocate_nothrow<Allocator, std::void_t<decltype(std::declval<Allocator&>().allocate_nothrow(size_t()))>>
+    : std::true_type {};
+
+} // namespace detail
 
 template <typename T>
 class SimpleAllocator {
@@ -26,15 +95,135 @@ public:
     };
 
     SimpleAllocator() = default;
-    template <typename U> SimpleAllocator(const SimpleAllocator<U>&) noexcept {}
+    template <typename U> VECTOR_CONSTEXPR SimpleAllocator(const SimpleAllocator<U>&) noexcept {}
 
-    pointer allocate(size_type n) {
+    // During constant evaluation only std::allocator and std::construct_at may create objects.
+    VECTOR_CONSTEXPR pointer allocate(size_type n) {
+#if VECTOR_HAS_CONSTEXPR_ALLOCATION
+        if (std::is_constant_evaluated()) {
+            return std::allocator<T>().allocate(n);
+        }
+#endif
         return static_cast<pointer>(::operator new(n * sizeof(T)));
     }
-    void deallocate(pointer ptr, size_type) {
+    VECTOR_CONSTEXPR pointer allocate_nothrow(size_type n) noexcept {
+#if VECTOR_HAS_CONSTEXPR_ALLOCATION
+        if (std::is_constant_evaluated()) {
+            return std::allocator<T>().allocate(n);
+        }
+#endif
+        return static_cast<pointer>(::operator new(n * sizeof(T), std::nothrow));
+    }
+    VECTOR_CONSTEXPR void deallocate(pointer ptr, size_type n) {
+#if VECTOR_HAS_CONSTEXPR_ALLOCATION
+        if (std::is_constant_evaluated()) {
+            if (ptr != nullptr) {
+                std::allocator<T>().deallocate(ptr, n);
+            }
+            return;
+        }
+#endif
+        (void)n;
         ::operator delete(ptr);
     }
     template <typename... Args>
+    VECTOR_CONSTEXPR void construct(pointer ptr, Args&&... args) {
+#if VECTOR_HAS_CONSTEXPR_ALLOCATION
+        if (std::is_constant_evaluated()) {
+            std::construct_at(ptr, std::forward<Args>(args)...);
+            return;
+        }
+#endif
+        ::new(ptr) T(std::forward<Args>(args)...);
+    }
+    VECTOR_CONSTEXPR void destroy(pointer ptr) {
+        ptr->~T();
+    }
+    VECTOR_CONSTEXPR size_type max_size() const noexcept {
+        return std::numeric_limits<size_type>::max() / sizeof(T);
+    }
+};
+
+template <typename T, std::size_t Alignment = 64>
+class AlignedAllocator {
+public:
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    // Rounds the byte size up to a whole number of alignment units so the tail is padded too.
+    pointer allocate(size_type n) {
+        size_type bytes = (n * sizeof(T) + Alignment - 1) & ~(Alignment - 1);
+        return static_cast<pointer>(::operator new(bytes, std::align_val_t(Alignment)));
+    }
+    pointer allocate_nothrow(size_type n) noexcept {
+        size_type bytes = (n * sizeof(T) + Alignment - 1) & ~(Alignment - 1);
+        return static_cast<pointer>(::operator new(bytes, std::align_val_t(Alignment), std::nothrow));
+    }
+    void deallocate(pointer ptr, size_type) {
+        ::operator delete(ptr, std::align_val_t(Alignment));
+    }
+    template <typename... Args>
+    void construct(pointer ptr, Args&&... args) {
+        ::new(ptr) T(std::forward<Args>(args)...);
+    }
+    void destroy(pointer ptr) {
+        ptr->~T();
+    }
+    size_type max_size() const noexcept {
+        return std::numeric_limits<size_type>::max() / sizeof(T);
+    }
+};
+
+// Allocates with new[] / delete[] so buffers can move to and from std::unique_ptr<T[]> without
+// copying. Restricted to trivial types, whose new[] storage needs no construction or cookie.
+template <typename T>
+class ArrayNewAllocator {
+public:
+    static_assert(std::is_trivial_v<T>, "ArrayNewAllocator requires a trivial element type");
+
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = ArrayNewAllocator<U>;
+    };
+
+    ArrayNewAllocator() = default;
+    template <typename U> ArrayNewAllocator(const ArrayNewAllocator<U>&) noexcept {}
+
+    pointer allocate(size_type n) {
+        return new T[n];
+    }
+    pointer allocate_nothrow(size_type n) noexcept {
+        return new (std::nothrow) T[n];
+    }
+    void deallocate(pointer ptr, size_type) {
+        delete[] ptr;
+    }
+    template <typename... Args>
     void construct(pointer ptr, Args&&... args) {
         ::new(ptr) T(std::forward<Args>(args)...);
     }
@@ -55,16 +244,37 @@ private:
     size_t capacity_;
     Allocator alloc_;
 
-    void check_index(size_t index) const {
+    VECTOR_CONSTEXPR void check_index(size_t index) const {
         if (index >= size_) {
-            throw std::out_of_range("Vector index out of range");
+            VECTOR_THROW(std::out_of_range("Vector index out of range"));
+        }
+    }
+
+    VECTOR_CONSTEXPR void reserve_more(size_t new_capacity) {
+        relocate(AllocTraits::allocate(alloc_, new_capacity), new_capacity);
+    }
+
+    VECTOR_CONSTEXPR VectorStatus try_reserve_more(size_t new_capacity) {
+        if (new_capacity > max_size()) {
+            return VectorErrc::length_error;
         }
+        T* new_data;
+        if constexpr (detail::has_allocate_nothrow<Allocator>::value) {
+            new_data = alloc_.allocate_nothrow(new_capacity);
+            if (new_data == nullptr) {
+                return VectorErrc::out_of_memory;
+            }
+        } else {
+            new_data = AllocTraits::allocate(alloc_, new_capacity);
+        }
+        relocate(new_data, new_capacity);
+        return VectorErrc::ok;
     }
 
-    void reserve_more(size_t new_capacity) {
-        T* new_data = AllocTraits::allocate(alloc_, new_capacity);
+    // Moves the elements into new_data (allocated with new_capacity) and adopts it.
+    VECTOR_CONSTEXPR void relocate(T* new_data, size_t new_capacity) {
         size_t constructed = 0;
-        try {
+        VECTOR_TRY {
             for (size_t i = 0; i < size_; ++i) {
                 AllocTraits::construct(alloc_, new_data + i, std::move_if_noexcept(data_[i]));
                 ++constructed;
@@ -75,12 +285,12 @@ private:
             AllocTraits::deallocate(alloc_, data_, capacity_);
             data_ = new_data;
             capacity_ = new_capacity;
-        } catch (...) {
+        } VECTOR_CATCH_ALL {
             for (size_t i = 0; i < constructed; ++i) {
                 AllocTraits::destroy(alloc_, new_data + i);
             }
             AllocTraits::deallocate(alloc_, new_data, new_capacity);
-            throw;
+            VECTOR_RETHROW;
         }
     }
 
@@ -94,20 +304,20 @@ public:
         using pointer = T*;
         using reference = T&;
 
-        Iterator(pointer ptr) : ptr_(ptr) {}
-        reference operator*() const { return *ptr_; }
-        pointer operator->() const { return ptr_; }
-        Iterator& operator++() { ++ptr_; return *this; }
-        Iterator operator++(int) { Iterator tmp = *this; ++ptr_; return tmp; }
-        Iterator& operator--() { --ptr_; return *this; }
-        Iterator operator--(int) { Iterator tmp = *this; --ptr_; return tmp; }
-        Iterator operator+(difference_type n) const { return Iterator(ptr_ + n); }
-        Iterator operator-(difference_type n) const { return Iterator(ptr_ - n); }
-        difference_type operator-(const Iterator& other) const { return ptr_ - other.ptr_; }
-        bool operator==(const Iterator& other) const { return ptr_ == other.ptr_; }
-        bool operator!=(const Iterator& other) const { return ptr_ != other.ptr_; }
-        bool operator==(const ConstIterator& other) const;
-        bool operator!=(const ConstIterator& other) const;
+        VECTOR_CONSTEXPR Iterator(pointer ptr) : ptr_(ptr) {}
+        VECTOR_CONSTEXPR reference operator*() const { return *ptr_; }
+        VECTOR_CONSTEXPR pointer operator->() const { return ptr_; }
+        VECTOR_CONSTEXPR Iterator& operator++() { ++ptr_; return *this; }
+        VECTOR_CONSTEXPR Iterator operator++(int) { Iterator tmp = *this; ++ptr_; return tmp; }
+        VECTOR_CONSTEXPR Iterator& operator--() { --ptr_; return *this; }
+        VECTOR_CONSTEXPR Iterator operator--(int) { Iterator tmp = *this; --ptr_; return tmp; }
+        VECTOR_CONSTEXPR Iterator operator+(difference_type n) const { return Iterator(ptr_ + n); }
+        VECTOR_CONSTEXPR Iterator operator-(difference_type n) const { return Iterator(ptr_ - n); }
+        VECTOR_CONSTEXPR difference_type operator-(const Iterator& other) const { return ptr_ - other.ptr_; }
+        VECTOR_CONSTEXPR bool operator==(const Iterator& other) const { return ptr_ == other.ptr_; }
+        VECTOR_CONSTEXPR bool operator!=(const Iterator& other) const { return ptr_ != other.ptr_; }
+        VECTOR_CONSTEXPR bool operator==(const ConstIterator& other) const;
+        VECTOR_CONSTEXPR bool operator!=(const ConstIterator& other) const;
 
     private:
         friend class Vector;
@@ -122,96 +332,100 @@ public:
         using pointer = const T*;
         using reference = const T&;
 
-        ConstIterator(const T* ptr) : ptr_(ptr) {}
-        ConstIterator(const Iterator& other) : ptr_(other.ptr_) {}
-        reference operator*() const { return *ptr_; }
-        pointer operator->() const { return ptr_; }
-        ConstIterator& operator++() { ++ptr_; return *this; }
-        ConstIterator operator++(int) { ConstIterator tmp = *this; ++ptr_; return tmp; }
-        ConstIterator& operator--() { --ptr_; return *this; }
-        ConstIterator operator--(int) { ConstIterator tmp = *this; --ptr_; return tmp; }
-        ConstIterator operator+(difference_type n) const { return ConstIterator(ptr_ + n); }
-        ConstIterator operator-(difference_type n) const { return ConstIterator(ptr_ - n); }
-        difference_type operator-(const ConstIterator& other) const { return ptr_ - other.ptr_; }
-        bool operator==(const ConstIterator& other) const { return ptr_ == other.ptr_; }
-        bool operator!=(const ConstIterator& other) const { return ptr_ != other.ptr_; }
-        bool operator==(const Iterator& other) const { return ptr_ == other.ptr_; }
-        bool operator!=(const Iterator& other) const { return ptr_ != other.ptr_; }
+        VECTOR_CONSTEXPR ConstIterator(const T* ptr) : ptr_(ptr) {}
+        VECTOR_CONSTEXPR ConstIterator(const Iterator& other) : ptr_(other.ptr_) {}
+        VECTOR_CONSTEXPR reference operator*() const { return *ptr_; }
+        VECTOR_CONSTEXPR pointer operator->() const { return ptr_; }
+        VECTOR_CONSTEXPR ConstIterator& operator++() { ++ptr_; return *this; }
+        VECTOR_CONSTEXPR ConstIterator operator++(int) { ConstIterator tmp = *this; ++ptr_; return tmp; }
+        VECTOR_CONSTEXPR ConstIterator& operator--() { --ptr_; return *this; }
+        VECTOR_CONSTEXPR ConstIterator operator--(int) { ConstIterator tmp = *this; --ptr_; return tmp; }
+        VECTOR_CONSTEXPR ConstIterator operator+(difference_type n) const { return ConstIterator(ptr_ + n); }
+        VECTOR_CONSTEXPR ConstIterator operator-(difference_type n) const { return ConstIterator(ptr_ - n); }
+        VECTOR_CONSTEXPR difference_type operator-(const ConstIterator& other) const { return ptr_ - other.ptr_; }
+        VECTOR_CONSTEXPR bool operator==(const ConstIterator& other) const { return ptr_ == other.ptr_; }
+        VECTOR_CONSTEXPR bool operator!=(const ConstIterator& other) const { return ptr_ != other.ptr_; }
+        VECTOR_CONSTEXPR bool operator==(const Iterator& other) const { return ptr_ == other.ptr_; }
+        VECTOR_CONSTEXPR bool operator!=(const Iterator& other) const { return ptr_ != other.ptr_; }
 
     private:
         friend class Vector;
         const T* ptr_;
     };
 
-    Vector() : data_(nullptr), size_(0), capacity_(0) {}
+    VECTOR_CONSTEXPR Vector() : data_(nullptr), size_(0), capacity_(0) {}
     
-    explicit Vector(size_t n) : data_(nullptr), size_(n), capacity_(n) {
+    VECTOR_CONSTEXPR explicit Vector(size_t n) : data_(nullptr), size_(n), capacity_(n) {
         if (n > 0) {
             data_ = AllocTraits::allocate(alloc_, n);
-            try {
+            VECTOR_TRY {
                 for (size_t i = 0; i < n; ++i) {
                     AllocTraits::construct(alloc_, data_ + i);
                 }
-            } catch (...) {
+            } VECTOR_CATCH_ALL {
                 AllocTraits::deallocate(alloc_, data_, n);
-                throw;
+                VECTOR_RETHROW;
             }
         }
     }
 
-    Vector(size_t n, const T& value) : data_(nullptr), size_(n), capacity_(n) {
+    VECTOR_CONSTEXPR Vector(size_t n, const T& value) : data_(nullptr), size_(n), capacity_(n) {
         if (n > 0) {
             data_ = AllocTraits::allocate(alloc_, n);
-            try {
+            VECTOR_TRY {
                 for (size_t i = 0; i < n; ++i) {
                     AllocTraits::construct(alloc_, data_ + i, value);
                 }
-            } catch (...) {
+            } VECTOR_CATCH_ALL {
                 AllocTraits::deallocate(alloc_, data_, n);
-                throw;
+                VECTOR_RETHROW;
             }
         }
     }
 
-    template <typename InputIt>
-    Vector(InputIt first, InputIt last) : data_(nullptr), size_(0), capacity_(0) {
+    template <typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+    VECTOR_CONSTEXPR Vector(InputIt first, InputIt last) : data_(nullptr), size_(0), capacity_(0) {
+        using Category = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+            reserve(static_cast<size_t>(std::distance(first, last)));
+        }
         for (auto it = first; it != last; ++it) {
             push_back(*it);
         }
     }
 
-    Vector(std::initializer_list<T> il) : Vector(il.begin(), il.end()) {}
+    VECTOR_CONSTEXPR Vector(std::initializer_list<T> il) : Vector(il.begin(), il.end()) {}
 
-    Vector(const Vector& other) : data_(nullptr), size_(other.size_), capacity_(other.size_),
+    VECTOR_CONSTEXPR Vector(const Vector& other) : data_(nullptr), size_(other.size_), capacity_(other.size_),
         alloc_(AllocTraits::select_on_container_copy_construction(other.alloc_)) {
         if (size_ > 0) {
             data_ = AllocTraits::allocate(alloc_, size_);
-            try {
+            VECTOR_TRY {
                 for (size_t i = 0; i < size_; ++i) {
                     AllocTraits::construct(alloc_, data_ + i, other.data_[i]);
                 }
-            } catch (...) {
+            } VECTOR_CATCH_ALL {
                 AllocTraits::deallocate(alloc_, data_, size_);
-                throw;
+                VECTOR_RETHROW;
             }
         }
     }
 
-    Vector(Vector&& other) noexcept 
+    VECTOR_CONSTEXPR Vector(Vector&& other) noexcept 
         : data_(other.data_), size_(other.size_), capacity_(other.capacity_), alloc_(std::move(other.alloc_)) {
         other.data_ = nullptr;
         other.size_ = 0;
         other.capacity_ = 0;
     }
 
-    ~Vector() {
+    VECTOR_CONSTEXPR ~Vector() {
         for (size_t i = 0; i < size_; ++i) {
             AllocTraits::destroy(alloc_, data_ + i);
         }
         AllocTraits::deallocate(alloc_, data_, capacity_);
     }
 
-    Vector& operator=(const Vector& other) {
+    VECTOR_CONSTEXPR Vector& operator=(const Vector& other) {
         Vector tmp(other);
         std::swap(data_, tmp.data_);
         std::swap(size_, tmp.size_);
@@ -222,7 +436,7 @@ public:
         return *this;
     }
 
-    Vector& operator=(Vector&& other) noexcept {
+    VECTOR_CONSTEXPR Vector& operator=(Vector&& other) noexcept {
         Vector tmp(std::move(other));
         std::swap(data_, tmp.data_);
         std::swap(size_, tmp.size_);
@@ -233,7 +447,7 @@ public:
         return *this;
     }
 
-    Vector& operator=(std::initializer_list<T> il) {
+    VECTOR_CONSTEXPR Vector& operator=(std::initializer_list<T> il) {
         Vector tmp(il);
         std::swap(data_, tmp.data_);
         std::swap(size_, tmp.size_);
@@ -242,57 +456,125 @@ public:
     }
 
     template <typename... Args>
-    void emplace_back(Args&&... args) {
+    VECTOR_CONSTEXPR void emplace_back(Args&&... args) {
         if (size_ == capacity_) {
-            size_t new_capacity = (capacity_ == 0) ? 1 : static_cast<size_t>(capacity_ * 1.5);
+            size_t new_capacity = (capacity_ < 2) ? capacity_ + 1 : capacity_ + capacity_ / 2;
             reserve_more(new_capacity);
         }
         AllocTraits::construct(alloc_, data_ + size_, std::forward<Args>(args)...);
         ++size_;
     }
 
-    void push_back(const T& value) { emplace_back(value); }
-    void push_back(T&& value) { emplace_back(std::move(value)); }
+    VECTOR_CONSTEXPR void push_back(const T& value) { emplace_back(value); }
+    VECTOR_CONSTEXPR void push_back(T&& value) { emplace_back(std::move(value)); }
 
-    void pop_back() {
+    VECTOR_CONSTEXPR void pop_back() {
         if (size_ > 0) {
             --size_;
             AllocTraits::destroy(alloc_, data_ + size_);
         }
     }
 
-    T& operator[](size_t index) { return data_[index]; }
-    const T& operator[](size_t index) const { return data_[index]; }
+    VECTOR_CONSTEXPR T& operator[](size_t index) { return data_[index]; }
+    VECTOR_CONSTEXPR const T& operator[](size_t index) const { return data_[index]; }
 
-    T& at(size_t index) {
+    VECTOR_CONSTEXPR T& at(size_t index) {
         check_index(index);
         return data_[index];
     }
-    const T& at(size_t index) const {
+    VECTOR_CONSTEXPR const T& at(size_t index) const {
         check_index(index);
         return data_[index];
     }
 
-    T& front() { return data_[0]; }
-    const T& front() const { return data_[0]; }
-    T& back() { return data_[size_ - 1]; }
-    const T& back() const { return data_[size_ - 1]; }
+    VECTOR_CONSTEXPR T& front() { return data_[0]; }
+    VECTOR_CONSTEXPR const T& front() const { return data_[0]; }
+    VECTOR_CONSTEXPR T& back() { return data_[size_ - 1]; }
+    VECTOR_CONSTEXPR const T& back() const { return data_[size_ - 1]; }
+
+    VECTOR_CONSTEXPR T* data() noexcept { return data_; }
+    VECTOR_CONSTEXPR const T* data() const noexcept { return data_; }
+
+    struct Buffer {
+        T* ptr;
+        size_t size;
+        size_t capacity;
+    };
+
+    // Takes ownership of storage obtained from alloc.allocate(capacity) whose first size
+    // elements are constructed. Nothing is copied.
+    static Vector adopt(T* ptr, size_t size, size_t capacity, const Allocator& alloc = Allocator()) {
+        if (size > capacity || (ptr == nullptr && capacity != 0)) {
+            VECTOR_THROW(std::invalid_argument("Vector::adopt given an inconsistent buffer"));
+        }
+        Vector result;
+        result.alloc_ = alloc;
+        result.data_ = ptr;
+        result.size_ = size;
+        result.capacity_ = capacity;
+        return result;
+    }
+
+    // Hands the storage to the caller, who must destroy the elements and return the memory
+    // through this Vector's allocator (see adopt). The Vector is left empty.
+    Buffer release() noexcept {
+        Buffer buffer{data_, size_, capacity_};
+        data_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+        return buffer;
+    }
+
+    class BufferDeleter {
+    public:
+        BufferDeleter() : size_(0), capacity_(0) {}
+        BufferDeleter(size_t size, size_t capacity, const Allocator& alloc)
+            : size_(size), capacity_(capacity), alloc_(alloc) {}
+
+        void operator()(T* ptr) {
+            for (size_t i = 0; i < size_; ++i) {
+                AllocTraits::destroy(alloc_, ptr + i);
+            }
+            AllocTraits::deallocate(alloc_, ptr, capacity_);
+        }
+
+        VECTOR_CONSTEXPR size_t size() const { return size_; }
+        VECTOR_CONSTEXPR size_t capacity() const { return capacity_; }
+        const Allocator& allocator() const { return alloc_; }
 
-    T* data() noexcept { return data_; }
-    const T* data() const noexcept { return data_; }
+    private:
+        size_t size_;
+        size_t capacity_;
+        Allocator alloc_;
+    };
 
-    size_t size() const { return size_; }
-    size_t capacity() const { return capacity_; }
-    bool empty() const { return size_ == 0; }
-    size_t max_size() const { return AllocTraits::max_size(alloc_); }
+    using UniquePtr = std::unique_ptr<T[], BufferDeleter>;
+
+    UniquePtr to_unique_ptr() {
+        BufferDeleter deleter(size_, capacity_, alloc_);
+        return UniquePtr(release().ptr, std::move(deleter));
+    }
 
-    void reserve(size_t new_capacity) {
+    static Vector from_unique_ptr(UniquePtr&& owned) {
+        const BufferDeleter& deleter = owned.get_deleter();
+        size_t size = deleter.size();
+        size_t capacity = deleter.capacity();
+        Allocator alloc = deleter.allocator();
+        return adopt(owned.release(), size, capacity, alloc);
+    }
+
+    VECTOR_CONSTEXPR size_t size() const { return size_; }
+    VECTOR_CONSTEXPR size_t capacity() const { return capacity_; }
+    VECTOR_CONSTEXPR bool empty() const { return size_ == 0; }
+    VECTOR_CONSTEXPR size_t max_size() const { return AllocTraits::max_size(alloc_); }
+
+    VECTOR_CONSTEXPR void reserve(size_t new_capacity) {
         if (new_capacity > capacity_) {
             reserve_more(new_capacity);
         }
     }
 
-    void shrink_to_fit() {
+    VECTOR_CONSTEXPR void shrink_to_fit() {
         if (capacity_ > size_) {
             if (size_ == 0) {
                 AllocTraits::deallocate(alloc_, data_, capacity_);
@@ -304,7 +586,22 @@ public:
         }
     }
 
-    void resize(size_t count) {
+    // Like resize(), but new elements are default-initialized, i.e. left indeterminate for trivial
+    // types, so callers can fill them directly (to_chars, read(), memcpy) without a zeroing pass.
+    // Growth is geometric so repeated appends stay amortized O(1).
+    void resize_for_overwrite(size_t count) {
+        static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+            "resize_for_overwrite requires a trivial element type");
+        if (count > capacity_) {
+            reserve_more(std::max(count, capacity_ + capacity_ / 2));
+        }
+        for (size_t i = size_; i < count; ++i) {
+            ::new(static_cast<void*>(data_ + i)) T;
+        }
+        size_ = count;
+    }
+
+    VECTOR_CONSTEXPR void resize(size_t count) {
         if (count < size_) {
             for (size_t i = count; i < size_; ++i) {
                 AllocTraits::destroy(alloc_, data_ + i);
@@ -321,7 +618,7 @@ public:
         }
     }
 
-    void resize(size_t count, const T& value) {
+    VECTOR_CONSTEXPR void resize(size_t count, const T& value) {
         if (count < size_) {
             for (size_t i = count; i < size_; ++i) {
                 AllocTraits::destroy(alloc_, data_ + i);
@@ -338,32 +635,75 @@ public:
         }
     }
 
-    void clear() {
+    // Non-throwing counterparts of reserve/push_back/emplace_back/resize. Allocation failure and
+    // sizes beyond max_size() are reported through the returned status and leave the Vector
+    // unchanged; allocation goes through allocate_nothrow() when the allocator provides it.
+    VECTOR_CONSTEXPR VectorStatus try_reserve(size_t new_capacity) {
+        if (new_capacity <= capacity_) {
+            return VectorErrc::ok;
+        }
+        return try_reserve_more(new_capacity);
+    }
+
+    template <typename... Args>
+    VECTOR_CONSTEXPR VectorStatus try_emplace_back(Args&&... args) {
+        if (size_ == capacity_) {
+            size_t new_capacity = (capacity_ < 2) ? capacity_ + 1 : capacity_ + capacity_ / 2;
+            VectorStatus status = try_reserve_more(new_capacity);
+            if (!status) {
+                return status;
+            }
+        }
+        AllocTraits::construct(alloc_, data_ + size_, std::forward<Args>(args)...);
+        ++size_;
+        return VectorErrc::ok;
+    }
+
+    VECTOR_CONSTEXPR VectorStatus try_push_back(const T& value) { return try_emplace_back(value); }
+    VECTOR_CONSTEXPR VectorStatus try_push_back(T&& value) { return try_emplace_back(std::move(value)); }
+
+    VECTOR_CONSTEXPR VectorStatus try_resize(size_t count) {
+        VectorStatus status = try_reserve(count);
+        if (status) {
+            resize(count);
+        }
+        return status;
+    }
+
+    VECTOR_CONSTEXPR VectorStatus try_resize(size_t count, const T& value) {
+        VectorStatus status = try_reserve(count);
+        if (status) {
+            resize(count, value);
+        }
+        return status;
+    }
+
+    VECTOR_CONSTEXPR void clear() {
         for (size_t i = 0; i < size_; ++i) {
             AllocTraits::destroy(alloc_, data_ + i);
         }
         size_ = 0;
     }
 
-    Iterator begin() { return Iterator(data_); }
-    Iterator end() { return Iterator(data_ + size_); }
-    ConstIterator begin() const { return ConstIterator(data_); }
-    ConstIterator end() const { return ConstIterator(data_ + size_); }
-    ConstIterator cbegin() const { return ConstIterator(data_); }
-    ConstIterator cend() const { return ConstIterator(data_); }
+    VECTOR_CONSTEXPR Iterator begin() { return Iterator(data_); }
+    VECTOR_CONSTEXPR Iterator end() { return Iterator(data_ + size_); }
+    VECTOR_CONSTEXPR ConstIterator begin() const { return ConstIterator(data_); }
+    VECTOR_CONSTEXPR ConstIterator end() const { return ConstIterator(data_ + size_); }
+    VECTOR_CONSTEXPR ConstIterator cbegin() const { return ConstIterator(data_); }
+    VECTOR_CONSTEXPR ConstIterator cend() const { return ConstIterator(data_ + size_); }
 
-    friend bool operator==(const Vector& lhs, const Vector& rhs) {
+    VECTOR_CONSTEXPR friend bool operator==(const Vector& lhs, const Vector& rhs) {
         return lhs.size_ == rhs.size_ && std::equal(lhs.begin(), lhs.end(), rhs.begin());
     }
-    friend bool operator!=(const Vector& lhs, const Vector& rhs) { return !(lhs == rhs); }
+    VECTOR_CONSTEXPR friend bool operator!=(const Vector& lhs, const Vector& rhs) { return !(lhs == rhs); }
 };
 template <typename T, typename Allocator>
-bool Vector<T, Allocator>::Iterator::operator==(const typename Vector<T, Allocator>::ConstIterator& other) const {
+VECTOR_CONSTEXPR bool Vector<T, Allocator>::Iterator::operator==(const typename Vector<T, Allocator>::ConstIterator& other) const {
     return ptr_ == other.ptr_;
 }
 
 template <typename T, typename Allocator>
-bool Vector<T, Allocator>::Iterator::operator!=(const typename Vector<T, Allocator>::ConstIterator& other) const {
+VECTOR_CONSTEXPR bool Vector<T, Allocator>::Iterator::operator!=(const typename Vector<T, Allocator>::ConstIterator& other) const {
     return ptr_ != other.ptr_;
 }
 
@@ -376,3 +716,13 @@ void swap(Vector<T, Allocator>& lhs, Vector<T, Allocator>& rhs) noexcept {
         std::swap(lhs.alloc_, rhs.alloc_);
     }
 }
+
+template <typename T>
+Vector<T, ArrayNewAllocator<T>> from_unique_ptr(std::unique_ptr<T[]> owned, size_t size) {
+    return Vector<T, ArrayNewAllocator<T>>::adopt(owned.release(), size, size);
+}
+
+template <typename T>
+std::unique_ptr<T[]> to_unique_ptr(Vector<T, ArrayNewAllocator<T>>&& vec) {
+    return std::unique_ptr<T[]>(vec.release().ptr);
+}
@@ -0,0 +1,352 @@
+#pragma once
+
+#include "customVector.hpp"
+#include "simd.hpp"
+#include "workerJoiner.hpp"
+#include <cmath>
+#include <thread>
+
+enum class Metric { L2, InnerProduct, Cosine };
+
+struct Neighbor {
+    size_t id;
+    float score;
+};
+
+namespace detail {
+
+inline float dot_kernel_scalar(const float* a, const float* b, size_t dim) {
+    float total = 0.0f;
+    for (size_t i = 0; i < dim; ++i) {
+        total += a[i] * b[i];
+    }
+    return total;
+}
+
+// Dots of four queries against one database row, so each row is loaded once per query tile.
+inline void dot_kernel_4x1_scalar(const float* q, size_t dim, const float* x, float* out) {
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    for (size_t i = 0; i < dim; ++i) {
+        s0 += q[i] * x[i];
+        s1 += q[dim + i] * x[i];
+        s2 += q[2 * dim + i] * x[i];
+        s3 += q[3 * dim + i] * x[i];
+    }
+    out[0] = s0;
+    out[1] = s1;
+    out[2] = s2;
+    out[3] = s3;
+}
+
+#if VECTOR_DISPATCH_X86
+VECTOR_TARGET_AVX2 inline float dot_kernel_avx2(const float* a, const float* b, size_t dim) {
+    size_t i = 0;
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    for (; i + 16 <= dim; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    for (; i + 8 <= dim; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+    float total = hsum(_mm256_add_ps(acc0, acc1));
+    for (; i < dim; ++i) {
+        total += a[i] * b[i];
+    }
+    return total;
+}
+
+VECTOR_TARGET_AVX512 inline float dot_kernel_avx512(const float* a, const float* b, size_t dim) {
+    size_t i = 0;
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    for (; i + 32 <= dim; i += 32) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+    }
+    if (i < dim) {
+        __mmask16 tail = static_cast<__mmask16>((dim - i >= 16) ? 0xFFFF : (1u << (dim - i)) - 1);
+        acc0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(tail, a + i), _mm512_maskz_loadu_ps(tail, b + i), acc0);
+        i += 16;
+    }
+    if (i < dim) {
+        __mmask16 tail = static_cast<__mmask16>((1u << (dim - i)) - 1);
+        acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(tail, a + i), _mm512_maskz_loadu_ps(tail, b + i), acc1);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+}
+
+VECTOR_TARGET_AVX2 inline void dot_kernel_4x1_avx2(const float* q, size_t dim, const float* x, float* out) {
+    const float* q0 = q;
+    const float* q1 = q + dim;
+    const float* q2 = q + 2 * dim;
+    const float* q3 = q + 3 * dim;
+    size_t i = 0;
+    __m256 a0 = _mm256_setzero_ps();
+    __m256 a1 = _mm256_setzero_ps();
+    __m256 a2 = _mm256_setzero_ps();
+    __m256 a3 = _mm256_setzero_ps();
+    for (; i + 8 <= dim; i += 8) {
+        __m256 xv = _mm256_loadu_ps(x + i);
+        a0 = _mm256_fmadd_ps(_mm256_loadu_ps(q0 + i), xv, a0);
+        a1 = _mm256_fmadd_ps(_mm256_loadu_ps(q1 + i), xv, a1);
+        a2 = _mm256_fmadd_ps(_mm256_loadu_ps(q2 + i), xv, a2);
+        a3 = _mm256_fmadd_ps(_mm256_loadu_ps(q3 + i), xv, a3);
+    }
+    float s0 = hsum(a0), s1 = hsum(a1), s2 = hsum(a2), s3 = hsum(a3);
+    for (; i < dim; ++i) {
+        s0 += q0[i] * x[i];
+        s1 += q1[i] * x[i];
+        s2 += q2[i] * x[i];
+        s3 += q3[i] * x[i];
+    }
+    out[0] = s0;
+    out[1] = s1;
+    out[2] = s2;
+    out[3] = s3;
+}
+
+VECTOR_TARGET_AVX512 inline void dot_kernel_4x1_avx512(const float* q, size_t dim, const float* x, float* out) {
+    const float* q0 = q;
+    const float* q1 = q + dim;
+    const float* q2 = q + 2 * dim;
+    const float* q3 = q + 3 * dim;
+    __m512 a0 = _mm512_setzero_ps();
+    __m512 a1 = _mm512_setzero_ps();
+    __m512 a2 = _mm512_setzero_ps();
+    __m512 a3 = _mm512_setzero_ps();
+    for (size_t i = 0; i < dim; i += 16) {
+        __mmask16 m = static_cast<__mmask16>((dim - i >= 16) ? 0xFFFF : (1u << (dim - i)) - 1);
+        __m512 xv = _mm512_maskz_loadu_ps(m, x + i);
+        a0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, q0 + i), xv, a0);
+        a1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, q1 + i), xv, a1);
+        a2 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, q2 + i), xv, a2);
+        a3 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, q3 + i), xv, a3);
+    }
+    out[0] = _mm512_reduce_add_ps(a0);
+    out[1] = _mm512_reduce_add_ps(a1);
+    out[2] = _mm512_reduce_add_ps(a2);
+    out[3] = _mm512_reduce_add_ps(a3);
+}
+#endif
+
+inline float dot_kernel(const float* a, const float* b, size_t dim) {
+#if VECTOR_DISPATCH_X86
+    static const auto kernel = select_kernel(&dot_kernel_scalar, nullptr, &dot_kernel_avx2, &dot_kernel_avx512);
+    return kernel(a, b, dim);
+#else
+    return dot_kernel_scalar(a, b, dim);
+#endif
+}
+
+inline void dot_kernel_4x1(const float* q, size_t dim, const float* x, float* out) {
+#if VECTOR_DISPATCH_X86
+    static const auto kernel = select_kernel(&dot_kernel_4x1_scalar, nullptr, &dot_kernel_4x1_avx2, &dot_kernel_4x1_avx512);
+    kernel(q, dim, x, out);
+#else
+    dot_kernel_4x1_scalar(q, dim, x, out);
+#endif
+}
+
+// Bounded max-heap on distance: the current worst candidate sits at the front.
+class TopK {
+public:
+    explicit TopK(size_t k) : k_(k) { heap_.reserve(k); }
+
+    void push(size_t id, float distance) {
+        if (heap_.size() < k_) {
+            heap_.push_back({id, distance});
+            std::push_heap(heap_.data(), heap_.data() + heap_.size(), by_distance);
+        } else if (distance < heap_.front().score) {
+            std::pop_heap(heap_.data(), heap_.data() + heap_.size(), by_distance);
+            heap_.back() = {id, distance};
+            std::push_heap(heap_.data(), heap_.data() + heap_.size(), by_distance);
+        }
+    }
+
+    Neighbor* sorted() {
+        std::sort_heap(heap_.data(), heap_.data() + heap_.size(), by_distance);
+        return heap_.data();
+    }
+
+    size_t size() const { return heap_.size(); }
+
+private:
+    static bool by_distance(const Neighbor& a, const Neighbor& b) {
+        return a.score < b.score || (a.score == b.score && a.id < b.id);
+    }
+
+    size_t k_;
+    Vector<Neighbor> heap_;
+};
+
+} // namespace detail
+
+class DenseIndex {
+public:
+    static constexpr size_t kQueryTile = 4;
+    static constexpr size_t kRowTile = 256;
+
+    explicit DenseIndex(size_t dim, Metric metric = Metric::L2) : dim_(dim), metric_(metric) {
+        if (dim == 0) {
+            VECTOR_THROW(std::invalid_argument("DenseIndex dimension must be non-zero"));
+        }
+    }
+
+    size_t dim() const { return dim_; }
+    size_t size() const { return norms_.size(); }
+    Metric metric() const { return metric_; }
+    const Vector<float>& rows() const { return rows_; }
+    const float* row(size_t id) const { return rows_.data() + id * dim_; }
+
+    void reserve(size_t n) {
+        rows_.reserve(n * dim_);
+        norms_.reserve(n);
+    }
+
+    size_t add(const float* row) {
+        add(row, 1);
+        return size() - 1;
+    }
+
+    void add(const float* rows, size_t n) {
+        size_t old_values = rows_.size();
+        size_t old_rows = norms_.size();
+        rows_.resize(old_values + n * dim_);
+        norms_.resize(old_rows + n);
+        std::copy(rows, rows + n * dim_, rows_.data() + old_values);
+        for (size_t r = 0; r < n; ++r) {
+            const float* x = rows_.data() + old_values + r * dim_;
+            norms_[old_rows + r] = row_norm(x);
+        }
+    }
+
+    void add(const Vector<float>& rows) {
+        check_shape(rows.size());
+        add(rows.data(), rows.size() / dim_);
+    }
+
+    Vector<Neighbor> search(const float* query, size_t k) const {
+        return search(query, 1, k, 1);
+    }
+
+    Vector<Neighbor> search(const Vector<float>& queries, size_t k, size_t threads = 0) const {
+        check_shape(queries.size());
+        return search(queries.data(), queries.size() / dim_, k, threads);
+    }
+
+    // Results are laid out row-major: neighbors for query q occupy [q * k, (q + 1) * k),
+    // best first, with k clamped to size().
+    Vector<Neighbor> search(const float* queries, size_t nq, size_t k, size_t threads = 0) const {
+        k = std::min(k, size());
+        Vector<Neighbor> results(nq * k);
+        if (nq == 0 || k == 0) {
+            return results;
+        }
+        if (threads == 0) {
+            threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+        size_t tiles = (nq + kQueryTile - 1) / kQueryTile;
+        threads = std::min(threads, tiles);
+        if (threads <= 1) {
+            search_range(queries, 0, nq, k, results.data());
+            return results;
+        }
+        {
+            // Joined before results is returned (or on a throw), not after it has been moved out.
+            Vector<std::thread> workers;
+            workers.reserve(threads);
+            detail::WorkerJoiner joiner{workers};
+            size_t per_thread = (tiles + threads - 1) / threads * kQueryTile;
+            for (size_t begin = 0; begin < nq; begin += per_thread) {
+                size_t end = std::min(begin + per_thread, nq);
+                workers.emplace_back([this, queries, begin, end, k, &results] {
+                    search_range(queries, begin, end, k, results.data());
+                });
+            }
+        }
+        return results;
+    }
+
+private:
+    size_t dim_;
+    Metric metric_;
+    Vector<float> rows_;
+    Vector<float> norms_;
+
+    float row_norm(const float* x) const {
+        float sq = detail::dot_kernel(x, x, dim_);
+        if (metric_ == Metric::Cosine) {
+            return sq > 0.0f ? 1.0f / std::sqrt(sq) : 0.0f;
+        }
+        return sq;
+    }
+
+    void check_shape(size_t n) const {
+        if (n % dim_ != 0) {
+            VECTOR_THROW(std::invalid_argument("DenseIndex input is not a whole number of rows"));
+        }
+    }
+
+    // Internal distances are "smaller is better"; scores are converted back on output.
+    float to_distance(float dot, float query_norm, float row_norm) const {
+        switch (metric_) {
+        case Metric::L2:
+            return std::max(0.0f, query_norm + row_norm - 2.0f * dot);
+        case Metric::InnerProduct:
+            return -dot;
+        case Metric::Cosine:
+            return -dot * query_norm * row_norm;
+        }
+        return 0.0f;
+    }
+
+    float to_score(float distance) const {
+        return metric_ == Metric::L2 ? distance : -distance;
+    }
+
+    // Database rows are visited in blocks of kRowTile; every query tile in the range is scored
+    // against a block before moving on, so the block stays cache-resident across queries.
+    void search_range(const float* queries, size_t begin, size_t end, size_t k, Neighbor* results) const {
+        size_t count = end - begin;
+        size_t tiles = (count + kQueryTile - 1) / kQueryTile;
+        const float* qbase = queries + begin * dim_;
+        Vector<float> padded;
+        if (count % kQueryTile != 0) {
+            padded.resize(tiles * kQueryTile * dim_, 0.0f);
+            std::copy(qbase, qbase + count * dim_, padded.data());
+            qbase = padded.data();
+        }
+        Vector<float> qnorm(count);
+        Vector<detail::TopK> heaps;
+        heaps.reserve(count);
+        for (size_t j = 0; j < count; ++j) {
+            qnorm[j] = row_norm(qbase + j * dim_);
+            heaps.emplace_back(k);
+        }
+        size_t n = size();
+        float dots[kQueryTile];
+        for (size_t r0 = 0; r0 < n; r0 += kRowTile) {
+            size_t r1 = std::min(r0 + kRowTile, n);
+            for (size_t t = 0; t < tiles; ++t) {
+                size_t first = t * kQueryTile;
+                size_t live = std::min(kQueryTile, count - first);
+                const float* qtile = qbase + first * dim_;
+                for (size_t r = r0; r < r1; ++r) {
+                    detail::dot_kernel_4x1(qtile, dim_, rows_.data() + r * dim_, dots);
+                    for (size_t j = 0; j < live; ++j) {
+                        heaps[first + j].push(r, to_distance(dots[j], qnorm[first + j], norms_[r]));
+                    }
+                }
+            }
+        }
+        for (size_t j = 0; j < count; ++j) {
+            Neighbor* best = heaps[j].sorted();
+            Neighbor* out = results + (begin + j) * k;
+            for (size_t i = 0; i < k; ++i) {
+                out[i] = {best[i].id, to_score(best[i].score)};
+            }
+        }
+    }
+};
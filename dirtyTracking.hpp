@@ -0,0 +1,224 @@
+#pragma once
+
+#include "customVector.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+// A Vector whose mutations go through tracked accessors that mark fixed-size chunks dirty in a
+// bitmap, so a checkpoint only rewrites the chunks changed since the previous one. Reads are
+// untracked and cost the same as on a plain Vector. Not safe for concurrent writers.
+template <typename T, typename Allocator = SimpleAllocator<T>>
+class DirtyTrackedVector {
+    static_assert(std::is_trivially_copyable_v<T>, "DirtyTrackedVector checkpoints raw element bytes");
+
+public:
+    static constexpr size_t kDefaultChunkBytes = 64 * 1024;
+
+    explicit DirtyTrackedVector(size_t chunk_bytes = kDefaultChunkBytes)
+        : chunk_elements_(std::max<size_t>(1, chunk_bytes / sizeof(T))) {}
+
+    // Takes over existing contents; everything starts dirty so the first checkpoint is complete.
+    explicit DirtyTrackedVector(Vector<T, Allocator>&& values, size_t chunk_bytes = kDefaultChunkBytes)
+        : DirtyTrackedVector(chunk_bytes) {
+        values_ = std::move(values);
+        mark_all_dirty();
+    }
+
+    size_t size() const noexcept { return values_.size(); }
+    bool empty() const noexcept { return values_.empty(); }
+    size_t chunk_elements() const noexcept { return chunk_elements_; }
+    size_t chunk_count() const noexcept { return (values_.size() + chunk_elements_ - 1) / chunk_elements_; }
+
+    const T& operator[](size_t index) const { return values_[index]; }
+    const T* data() const noexcept { return values_.data(); }
+    const Vector<T, Allocator>& values() const noexcept { return values_; }
+
+    void set(size_t index, const T& value) {
+        check_range(index, 1);
+        values_[index] = value;
+        mark_chunk(index / chunk_elements_);
+    }
+
+    // Marks index's chunk dirty up front; the reference must not be kept past the next checkpoint.
+    T& mutable_at(size_t index) {
+        check_range(index, 1);
+        mark_chunk(index / chunk_elements_);
+        return values_[index];
+    }
+
+    // Marks [first, first + n) dirty and returns a pointer for writing it in bulk.
+    T* mutable_range(size_t first, size_t n) {
+        check_range(first, n);
+        mark_dirty(first, n);
+        return values_.data() + first;
+    }
+
+    void push_back(const T& value) {
+        values_.push_back(value);
+        sync_bitmap();
+        mark_chunk((values_.size() - 1) / chunk_elements_);
+    }
+
+    void resize(size_t n) { resize(n, T()); }
+
+    void resize(size_t n, const T& value) {
+        size_t old = values_.size();
+        values_.resize(n, value);
+        sync_bitmap();
+        if (n > old) {
+            mark_dirty(old, n - old);
+        }
+    }
+
+    void reserve(size_t n) { values_.reserve(n); }
+
+    void mark_dirty(size_t first, size_t n) {
+        check_range(first, n);
+        if (n == 0) {
+            return;
+        }
+        size_t c0 = first / chunk_elements_;
+        size_t c1 = (first + n - 1) / chunk_elements_;
+        for (size_t c = c0; c <= c1;) {
+            if (c % 64 == 0 && c + 64 <= c1 + 1) {
+                dirty_[c / 64] = ~uint64_t(0);
+                c += 64;
+            } else {
+                mark_chunk(c++);
+            }
+        }
+    }
+
+    void mark_all_dirty() {
+        sync_bitmap();
+        mark_dirty(0, values_.size());
+    }
+
+    void clear_dirty() {
+        for (size_t w = 0; w < dirty_.size(); ++w) {
+            dirty_[w] = 0;
+        }
+    }
+
+    bool is_chunk_dirty(size_t chunk) const { return (dirty_[chunk / 64] >> (chunk % 64)) & 1; }
+
+    size_t dirty_chunk_count() const {
+        size_t count = 0;
+        for (size_t w = 0; w < dirty_.size(); ++w) {
+            count += static_cast<size_t>(__builtin_popcountll(dirty_[w]));
+        }
+        return count;
+    }
+
+    // Calls f(first, count) for each maximal run of dirty chunks, in element units and clipped to
+    // size(). Clean words of the bitmap are skipped 64 chunks at a time.
+    template <typename F>
+    void for_each_dirty_region(F&& f) const {
+        size_t chunks = chunk_count();
+        size_t run_start = 0;
+        size_t run_end = 0;
+        bool in_run = false;
+        for (size_t w = 0; w < dirty_.size(); ++w) {
+            uint64_t bits = dirty_[w];
+            while (bits != 0) {
+                size_t c = w * 64 + static_cast<size_t>(__builtin_ctzll(bits));
+                bits &= bits - 1;
+                if (c >= chunks) {
+                    break;
+                }
+                if (in_run && c == run_end) {
+                    ++run_end;
+                    continue;
+                }
+                if (in_run) {
+                    emit_region(f, run_start, run_end);
+                }
+                in_run = true;
+                run_start = c;
+                run_end = c + 1;
+            }
+        }
+        if (in_run) {
+            emit_region(f, run_start, run_end);
+        }
+    }
+
+    size_t dirty_bytes() const {
+        size_t total = 0;
+        for_each_dirty_region([&](size_t, size_t count) { total += count * sizeof(T); });
+        return total;
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    // Brings the image of the elements at file offset base_offset in fd up to date: dirty
+    // regions are written with pwrite and the file is truncated or extended if size() changed
+    // since the last checkpoint. Clears the dirty set and returns the number of bytes written.
+    // The first checkpoint to a fresh file must follow mark_all_dirty() (or construction from
+    // an existing Vector).
+    size_t checkpoint(int fd, off_t base_offset = 0) {
+        size_t written = 0;
+        for_each_dirty_region([&](size_t first, size_t count) {
+            const char* p = reinterpret_cast<const char*>(values_.data() + first);
+            size_t n = count * sizeof(T);
+            off_t offset = base_offset + static_cast<off_t>(first * sizeof(T));
+            while (n > 0) {
+                ssize_t done = ::pwrite(fd, p, n, offset);
+                if (done < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    VECTOR_THROW(std::system_error(errno, std::generic_category(), "checkpoint"));
+                }
+                p += done;
+                n -= static_cast<size_t>(done);
+                offset += done;
+                written += static_cast<size_t>(done);
+            }
+        });
+        if (values_.size() != checkpoint_size_) {
+            if (::ftruncate(fd, base_offset + static_cast<off_t>(values_.size() * sizeof(T))) != 0) {
+                VECTOR_THROW(std::system_error(errno, std::generic_category(), "checkpoint"));
+            }
+            checkpoint_size_ = values_.size();
+        }
+        clear_dirty();
+        return written;
+    }
+#endif
+
+private:
+    Vector<T, Allocator> values_;
+    Vector<uint64_t> dirty_;
+    size_t chunk_elements_;
+    size_t checkpoint_size_ = 0;
+
+    void check_range(size_t first, size_t n) const {
+        if (first > values_.size() || n > values_.size() - first) {
+            VECTOR_THROW(std::out_of_range("DirtyTrackedVector index out of range"));
+        }
+    }
+
+    void mark_chunk(size_t chunk) { dirty_[chunk / 64] |= uint64_t(1) << (chunk % 64); }
+
+    void sync_bitmap() {
+        size_t words = (chunk_count() + 63) / 64;
+        if (words > dirty_.size()) {
+            dirty_.resize(words, 0);
+        }
+    }
+
+    template <typename F>
+    void emit_region(F& f, size_t chunk_begin, size_t chunk_end) const {
+        size_t first = chunk_begin * chunk_elements_;
+        size_t last = std::min(values_.size(), chunk_end * chunk_elements_);
+        f(first, last - first);
+    }
+};
@@ -0,0 +1,316 @@
+#pragma once
+
+#include "customVector.hpp"
+#include "vectorHash.hpp"
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+enum class EvictionPolicy { LRU, Clock };
+
+// A fixed-capacity cache with no allocation after construction. Entries live in a slab Vector
+// sized to the capacity up front, and the recency list links slots by 32-bit index rather than
+// by pointer. Lookups go through a linear-probing table of slot indices, with backward-shift
+// deletion so no tombstones build up. get, put, erase and eviction are all O(1).
+//
+// With EvictionPolicy::Clock, a hit only sets the slot's reference bit, and that write is
+// skipped when the bit is already set, so hot entries stop dirtying cache lines. Eviction then
+// sweeps a hand over the slab and takes the first entry whose bit is clear, clearing bits as it
+// passes. The cost is an approximation of LRU order.
+//
+// Not thread-safe; shard by key for concurrent use.
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class FlatLruCache {
+public:
+    explicit FlatLruCache(size_t capacity, EvictionPolicy policy = EvictionPolicy::LRU) : policy_(policy) {
+        if (capacity == 0 || capacity > (size_t(1) << 30)) {
+            VECTOR_THROW(std::invalid_argument("FlatLruCache capacity must be in [1, 2^30]"));
+        }
+        slots_.resize(capacity);
+        size_t table_size = 16;
+        while (table_size < capacity * 2) {
+            table_size *= 2;
+        }
+        table_.resize(table_size, 0);
+    }
+
+    FlatLruCache(const FlatLruCache&) = delete;
+    FlatLruCache& operator=(const FlatLruCache&) = delete;
+
+    // The moved-from cache is left with capacity 0: lookups and erase() miss, clear() and
+    // destruction are fine, and put() throws std::logic_error.
+    FlatLruCache(FlatLruCache&& other) noexcept
+        : slots_(std::move(other.slots_)), table_(std::move(other.table_)), policy_(other.policy_),
+          size_(std::exchange(other.size_, 0)), used_(std::exchange(other.used_, 0)),
+          free_(std::exchange(other.free_, kNil)), head_(std::exchange(other.head_, kNil)),
+          tail_(std::exchange(other.tail_, kNil)), hand_(std::exchange(other.hand_, 0)) {}
+
+    ~FlatLruCache() { destroy_all(); }
+
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    size_t capacity() const noexcept { return slots_.size(); }
+    EvictionPolicy policy() const noexcept { return policy_; }
+
+    // Returns the cached value and marks it recently used, or null on a miss. The pointer is
+    // valid until the entry is evicted or erased.
+    V* get(const K& key) {
+        uint32_t s = find_slot(key);
+        if (s == kNil) {
+            return nullptr;
+        }
+        touch(s);
+        return value_of(s);
+    }
+
+    // Lookup without updating recency.
+    const V* peek(const K& key) const {
+        uint32_t s = find_slot(key);
+        return s == kNil ? nullptr : value_of(s);
+    }
+
+    bool contains(const K& key) const { return find_slot(key) != kNil; }
+
+    // Inserts or overwrites key's value and marks it recently used, evicting an entry first if
+    // the cache is full. Returns true if the key was not present.
+    template <typename KK, typename VV>
+    bool put(KK&& key, VV&& value) {
+        if (table_.empty()) {
+            VECTOR_THROW(std::logic_error("FlatLruCache used after move"));
+        }
+        uint32_t h = hash_of(key);
+        size_t pos = probe(key, h);
+        if (table_[pos] != 0) {
+            uint32_t s = table_[pos] - 1;
+            *value_of(s) = std::forward<VV>(value);
+            touch(s);
+            return false;
+        }
+        if (size_ == slots_.size()) {
+            evict();
+            pos = probe(key, h);
+        }
+        uint32_t s = take_free_slot();
+        Slot& slot = slots_[s];
+        VECTOR_TRY {
+            ::new (static_cast<void*>(slot.key)) K(std::forward<KK>(key));
+            VECTOR_TRY {
+                ::new (static_cast<void*>(slot.value)) V(std::forward<VV>(value));
+            }
+            VECTOR_CATCH_ALL {
+                key_of(s)->~K();
+                VECTOR_RETHROW;
+            }
+        }
+        VECTOR_CATCH_ALL {
+            release_slot(s);
+            VECTOR_RETHROW;
+        }
+        slot.hash = h;
+        slot.occupied = 1;
+        slot.referenced = 0;
+        table_[pos] = s + 1;
+        if (policy_ == EvictionPolicy::LRU) {
+            link_front(s);
+        }
+        ++size_;
+        return true;
+    }
+
+    bool erase(const K& key) {
+        if (table_.empty()) {
+            return false;
+        }
+        size_t pos = probe(key, hash_of(key));
+        if (table_[pos] == 0) {
+            return false;
+        }
+        remove_at(pos);
+        return true;
+    }
+
+    void clear() noexcept {
+        destroy_all();
+        for (size_t i = 0; i < table_.size(); ++i) {
+            table_[i] = 0;
+        }
+        size_ = 0;
+        used_ = 0;
+        free_ = kNil;
+        head_ = kNil;
+        tail_ = kNil;
+        hand_ = 0;
+    }
+
+    // Visits entries from most to least recently used (LRU), or in slab order (Clock).
+    template <typename F>
+    void for_each(F&& f) const {
+        if (policy_ == EvictionPolicy::LRU) {
+            for (uint32_t s = head_; s != kNil; s = slots_[s].next) {
+                f(*key_of(s), *value_of(s));
+            }
+            return;
+        }
+        for (uint32_t s = 0; s < used_; ++s) {
+            if (slots_[s].occupied) {
+                f(*key_of(s), *value_of(s));
+            }
+        }
+    }
+
+private:
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    struct Slot {
+        alignas(K) unsigned char key[sizeof(K)];
+        alignas(V) unsigned char value[sizeof(V)];
+        uint32_t prev;
+        uint32_t next;
+        uint32_t hash;
+        uint8_t occupied;
+        uint8_t referenced;
+    };
+
+    Vector<Slot> slots_;
+    Vector<uint32_t> table_; // slot + 1, 0 when empty
+    EvictionPolicy policy_;
+    size_t size_ = 0;
+    uint32_t used_ = 0; // slots [0, used_) have been handed out at least once
+    uint32_t free_ = kNil;
+    uint32_t head_ = kNil;
+    uint32_t tail_ = kNil;
+    uint32_t hand_ = 0;
+
+    K* key_of(uint32_t s) noexcept { return std::launder(reinterpret_cast<K*>(slots_[s].key)); }
+    const K* key_of(uint32_t s) const noexcept { return std::launder(reinterpret_cast<const K*>(slots_[s].key)); }
+    V* value_of(uint32_t s) noexcept { return std::launder(reinterpret_cast<V*>(slots_[s].value)); }
+    const V* value_of(uint32_t s) const noexcept { return std::launder(reinterpret_cast<const V*>(slots_[s].value)); }
+
+    template <typename KK>
+    uint32_t hash_of(const KK& key) const {
+        return static_cast<uint32_t>(detail::hash_mix(static_cast<uint64_t>(Hash{}(key)), detail::kHashP0));
+    }
+
+    // Table position holding key, or the empty position where it would be inserted. The table
+    // must be non-empty, i.e. the cache not moved from.
+    template <typename KK>
+    size_t probe(const KK& key, uint32_t h) const {
+        size_t mask = table_.size() - 1;
+        for (size_t i = h & mask;; i = (i + 1) & mask) {
+            uint32_t entry = table_[i];
+            if (entry == 0 || (slots_[entry - 1].hash == h && KeyEqual{}(*key_of(entry - 1), key))) {
+                return i;
+            }
+        }
+    }
+
+    uint32_t find_slot(const K& key) const {
+        if (table_.empty()) {
+            return kNil;
+        }
+        uint32_t entry = table_[probe(key, hash_of(key))];
+        return entry == 0 ? kNil : entry - 1;
+    }
+
+    void touch(uint32_t s) noexcept {
+        if (policy_ == EvictionPolicy::Clock) {
+            if (!slots_[s].referenced) {
+                slots_[s].referenced = 1;
+            }
+        } else if (s != head_) {
+            unlink(s);
+            link_front(s);
+        }
+    }
+
+    void link_front(uint32_t s) noexcept {
+        slots_[s].prev = kNil;
+        slots_[s].next = head_;
+        if (head_ != kNil) {
+            slots_[head_].prev = s;
+        }
+        head_ = s;
+        if (tail_ == kNil) {
+            tail_ = s;
+        }
+    }
+
+    void unlink(uint32_t s) noexcept {
+        uint32_t prev = slots_[s].prev;
+        uint32_t next = slots_[s].next;
+        (prev != kNil ? slots_[prev].next : head_) = next;
+        (next != kNil ? slots_[next].prev : tail_) = prev;
+    }
+
+    uint32_t take_free_slot() noexcept {
+        if (free_ != kNil) {
+            uint32_t s = free_;
+            free_ = slots_[s].next;
+            return s;
+        }
+        return used_++;
+    }
+
+    void release_slot(uint32_t s) noexcept {
+        slots_[s].occupied = 0;
+        slots_[s].next = free_;
+        free_ = s;
+    }
+
+    void evict() {
+        uint32_t victim;
+        if (policy_ == EvictionPolicy::LRU) {
+            victim = tail_;
+        } else {
+            // Every slot is occupied when evicting, so the sweep ends within two passes.
+            for (;;) {
+                Slot& slot = slots_[hand_];
+                uint32_t current = hand_;
+                hand_ = hand_ + 1 == slots_.size() ? 0 : hand_ + 1;
+                if (!slot.referenced) {
+                    victim = current;
+                    break;
+                }
+                slot.referenced = 0;
+            }
+        }
+        remove_at(probe(*key_of(victim), slots_[victim].hash));
+    }
+
+    // Removes the entry at table position pos, then shifts later members of its probe run back
+    // so every key stays reachable from its home position.
+    void remove_at(size_t pos) noexcept {
+        uint32_t s = table_[pos] - 1;
+        if (policy_ == EvictionPolicy::LRU) {
+            unlink(s);
+        }
+        key_of(s)->~K();
+        value_of(s)->~V();
+        release_slot(s);
+        --size_;
+
+        size_t mask = table_.size() - 1;
+        size_t hole = pos;
+        for (size_t j = (hole + 1) & mask; table_[j] != 0; j = (j + 1) & mask) {
+            size_t home = slots_[table_[j] - 1].hash & mask;
+            bool stays = (j > hole) ? (home > hole && home <= j) : (home > hole || home <= j);
+            if (!stays) {
+                table_[hole] = table_[j];
+                hole = j;
+            }
+        }
+        table_[hole] = 0;
+    }
+
+    void destroy_all() noexcept {
+        for (uint32_t s = 0; s < used_; ++s) {
+            if (slots_[s].occupied) {
+                key_of(s)->~K();
+                value_of(s)->~V();
+                slots_[s].occupied = 0;
+            }
+        }
+    }
+};
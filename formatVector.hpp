@@ -0,0 +1,147 @@
+#pragma once
+
+#include "customVector.hpp"
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+struct FormatSpec {
+    std::string_view separator = " ";
+    std::string_view prefix = "";
+    std::string_view suffix = "\n";
+    std::chars_format float_format = std::chars_format::general;
+    int precision = -1;
+};
+
+namespace detail {
+
+constexpr size_t kFormatSlack = 64;
+
+template <typename Allocator>
+char* format_reserve(Vector<char, Allocator>& buffer, char* cursor, size_t needed) {
+    size_t used = static_cast<size_t>(cursor - buffer.data());
+    if (buffer.size() - used < needed) {
+        buffer.resize_for_overwrite(std::max(used + needed, buffer.size() * 2));
+    }
+    return buffer.data() + used;
+}
+
+template <typename Allocator>
+char* format_append(Vector<char, Allocator>& buffer, char* cursor, std::string_view text) {
+    if (text.empty()) {
+        return cursor;
+    }
+    cursor = format_reserve(buffer, cursor, text.size());
+    std::memcpy(cursor, text.data(), text.size());
+    return cursor + text.size();
+}
+
+template <typename T, typename Allocator>
+char* format_value(Vector<char, Allocator>& buffer, char* cursor, const T& value, const FormatSpec& spec) {
+    if constexpr (std::is_same_v<T, bool>) {
+        return format_append(buffer, cursor, value ? "true" : "false");
+    } else if constexpr (std::is_same_v<T, char>) {
+        return format_append(buffer, cursor, std::string_view(&value, 1));
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        size_t room = kFormatSlack;
+        for (;;) {
+            cursor = format_reserve(buffer, cursor, room);
+            char* limit = cursor + room;
+            std::to_chars_result result;
+            if constexpr (std::is_floating_point_v<T>) {
+                result = spec.precision < 0 ? std::to_chars(cursor, limit, value, spec.float_format)
+                                            : std::to_chars(cursor, limit, value, spec.float_format, spec.precision);
+            } else {
+                result = std::to_chars(cursor, limit, value);
+            }
+            if (result.ec == std::errc()) {
+                return result.ptr;
+            }
+            room *= 4;
+        }
+    } else {
+        static_assert(std::is_convertible_v<const T&, std::string_view>, "format_to supports arithmetic and string-like elements");
+        return format_append(buffer, cursor, std::string_view(value));
+    }
+}
+
+} // namespace detail
+
+// Appends the textual form of elements [first, first + n) to buffer with std::to_chars, writing
+// straight into the buffer's storage. The buffer keeps its capacity between calls, so a reused
+// buffer stops allocating once it has grown to the largest output.
+template <typename T, typename Allocator>
+void format_to(Vector<char, Allocator>& buffer, const T* first, size_t n, const FormatSpec& spec = FormatSpec()) {
+    size_t start = buffer.size();
+    char* cursor = buffer.data() + start;
+    cursor = detail::format_append(buffer, cursor, spec.prefix);
+    for (size_t i = 0; i < n; ++i) {
+        if (i > 0) {
+            cursor = detail::format_append(buffer, cursor, spec.separator);
+        }
+        cursor = detail::format_value(buffer, cursor, first[i], spec);
+    }
+    cursor = detail::format_append(buffer, cursor, spec.suffix);
+    buffer.resize(static_cast<size_t>(cursor - buffer.data()));
+}
+
+template <typename T, typename VecAllocator, typename Allocator>
+void format_to(Vector<char, Allocator>& buffer, const Vector<T, VecAllocator>& vec, const FormatSpec& spec = FormatSpec()) {
+    format_to(buffer, vec.data(), vec.size(), spec);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+// Writes all of [data, data + n) to fd, retrying partial writes and EINTR.
+inline void write_all(int fd, const char* data, size_t n) {
+    while (n > 0) {
+        ssize_t written = ::write(fd, data, n);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            VECTOR_THROW(std::system_error(errno, std::generic_category(), "write_text"));
+        }
+        data += written;
+        n -= static_cast<size_t>(written);
+    }
+}
+
+// Formats vec into buffer and writes it to fd in large blocks; output is flushed every
+// kFlushBytes so memory stays bounded for very large vectors. buffer is cleared on return.
+template <typename T, typename VecAllocator, typename Allocator>
+void write_text(int fd, const Vector<T, VecAllocator>& vec, Vector<char, Allocator>& buffer, const FormatSpec& spec = FormatSpec()) {
+    constexpr size_t kFlushBytes = 1 << 20;
+    buffer.clear();
+    FormatSpec piece = spec;
+    piece.suffix = "";
+    size_t i = 0;
+    do {
+        size_t n = std::min(vec.size() - i, kFlushBytes / detail::kFormatSlack);
+        piece.prefix = (i == 0) ? spec.prefix : spec.separator;
+        format_to(buffer, vec.data() + i, n, piece);
+        i += n;
+        if (buffer.size() >= kFlushBytes || i == vec.size()) {
+            if (i == vec.size()) {
+                format_to(buffer, vec.data(), 0, FormatSpec{"", "", spec.suffix});
+            }
+            write_all(fd, buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    } while (i < vec.size());
+}
+
+template <typename T, typename VecAllocator>
+void write_text(int fd, const Vector<T, VecAllocator>& vec, const FormatSpec& spec = FormatSpec()) {
+    Vector<char> buffer;
+    write_text(fd, vec, buffer, spec);
+}
+
+#endif
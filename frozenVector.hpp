@@ -0,0 +1,105 @@
+#pragma once
+
+#include "customVector.hpp"
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+// A fixed-size, read-only array with Vector's read API. Declared `static constexpr`, it is laid
+// out at compile time and lands in read-only data, so lookup tables cost nothing at startup and
+// their pages are shared between processes. Elements must be default-constructible literal types.
+template <typename T, size_t N>
+class FrozenVector {
+public:
+    using value_type = T;
+    using const_iterator = const T*;
+    using iterator = const T*;
+
+    constexpr FrozenVector() : elements_{} {}
+
+    // Copies [first, first + N).
+    constexpr explicit FrozenVector(const T* first) : elements_{} {
+        for (size_t i = 0; i < N; ++i) {
+            elements_[i] = first[i];
+        }
+    }
+
+    constexpr size_t size() const noexcept { return N; }
+    constexpr size_t capacity() const noexcept { return N; }
+    constexpr bool empty() const noexcept { return N == 0; }
+
+    constexpr const T& operator[](size_t index) const { return elements_[index]; }
+    constexpr const T& at(size_t index) const {
+        if (index >= N) {
+            VECTOR_THROW(std::out_of_range("FrozenVector index out of range"));
+        }
+        return elements_[index];
+    }
+    constexpr const T& front() const { return elements_[0]; }
+    constexpr const T& back() const { return elements_[N - 1]; }
+    constexpr const T* data() const noexcept { return elements_; }
+
+    constexpr const T* begin() const noexcept { return elements_; }
+    constexpr const T* end() const noexcept { return elements_ + N; }
+    constexpr const T* cbegin() const noexcept { return elements_; }
+    constexpr const T* cend() const noexcept { return elements_ + N; }
+
+    // A mutable runtime copy.
+    template <typename Allocator = SimpleAllocator<T>>
+    Vector<T, Allocator> thaw() const {
+        return Vector<T, Allocator>(begin(), end());
+    }
+
+    friend constexpr bool operator==(const FrozenVector& lhs, const FrozenVector& rhs) {
+        for (size_t i = 0; i < N; ++i) {
+            if (!(lhs.elements_[i] == rhs.elements_[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+    friend constexpr bool operator!=(const FrozenVector& lhs, const FrozenVector& rhs) { return !(lhs == rhs); }
+
+private:
+    T elements_[N > 0 ? N : 1];
+};
+
+template <typename T, size_t N, typename Allocator>
+VECTOR_CONSTEXPR bool operator==(const FrozenVector<T, N>& lhs, const Vector<T, Allocator>& rhs) {
+    if (rhs.size() != N) {
+        return false;
+    }
+    for (size_t i = 0; i < N; ++i) {
+        if (!(lhs[i] == rhs[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T, size_t N, typename Allocator>
+VECTOR_CONSTEXPR bool operator==(const Vector<T, Allocator>& lhs, const FrozenVector<T, N>& rhs) {
+    return rhs == lhs;
+}
+
+#if VECTOR_HAS_CONSTEXPR_ALLOCATION
+
+// Copies a Vector built during constant evaluation into a FrozenVector of known size:
+//   static constexpr auto kTable = freeze<256>(make_table());
+template <size_t N, typename T, typename Allocator>
+constexpr FrozenVector<T, N> freeze(const Vector<T, Allocator>& vec) {
+    if (vec.size() != N) {
+        VECTOR_THROW(std::length_error("freeze: size does not match N"));
+    }
+    return FrozenVector<T, N>(vec.data());
+}
+
+// Runs a captureless builder lambda at compile time, once to size the result and once to fill it:
+//   static constexpr auto kTable = freeze([] { Vector<int> v; ...; return v; });
+template <typename Builder>
+consteval auto freeze(Builder) {
+    constexpr size_t n = Builder()().size();
+    return freeze<n>(Builder()());
+}
+
+#endif
@@ -0,0 +1,343 @@
+#pragma once
+
+#include "customVector.hpp"
+#include "simd.hpp"
+#include "workerJoiner.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+
+// Binning kernels for feature preparation. Both are split in two phases: a SIMD pass turns a
+// block of values into bin or bucket indices (compare, scale and clamp for histogram(); a
+// boundary count or a gathered branchless binary search for bucketize()), and a scalar pass
+// consumes them. histogram() increments kHistogramLanes interleaved sub-histograms so
+// consecutive equal bins do not serialize on a store-to-load dependency, and when run on several
+// threads every thread fills private counters that are summed at the end.
+//
+// The SIMD paths cover float, the common case for feature columns; other arithmetic types use
+// the scalar kernels, which give identical results.
+namespace detail {
+
+constexpr size_t kHistogramBlock = 256;
+constexpr size_t kHistogramLanes = 4;
+constexpr size_t kHistogramMinChunk = size_t(1) << 16;
+constexpr size_t kHistogramFlush = size_t(1) << 30;
+constexpr size_t kBucketizeLinearMax = 16;
+static_assert(kHistogramLanes == 4, "histogram_accumulate unrolls over four sub-histograms");
+
+// float columns are scaled in float so the scalar and SIMD kernels agree bit for bit.
+template <typename T>
+using HistogramScale = std::conditional_t<std::is_same_v<T, float>, float, double>;
+
+// out[i] is the bin of x[i], or bins for values outside [lo, hi] and NaN. Positions at or past
+// the last bin clamp to it before the conversion, as the SIMD kernels' unsigned min does.
+template <typename T>
+void histogram_bins_scalar(const T* x, size_t n, T lo, T hi, HistogramScale<T> scale, uint32_t bins, uint32_t* out) {
+    using S = HistogramScale<T>;
+    for (size_t i = 0; i < n; ++i) {
+        T v = x[i];
+        if (v >= lo && v <= hi) {
+            S pos = (static_cast<S>(v) - static_cast<S>(lo)) * scale;
+            out[i] = pos < static_cast<S>(bins - 1) ? static_cast<uint32_t>(pos) : bins - 1;
+        } else {
+            out[i] = bins;
+        }
+    }
+}
+
+// Index of the first boundary greater than v, with NaN past every boundary (std::upper_bound
+// order). Branch-free, so the loop runs log2(count) steps for every value.
+template <typename T>
+uint16_t bucket_of(T v, const T* boundaries, size_t count) {
+    const T* first = boundaries;
+    for (size_t len = count; len > 1;) {
+        size_t half = len / 2;
+        first = !(v < first[half]) ? first + half : first;
+        len -= half;
+    }
+    return static_cast<uint16_t>((first - boundaries) + !(v < *first));
+}
+
+template <typename T>
+void bucketize_scalar(const T* x, size_t n, const T* boundaries, size_t count, uint16_t* out) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = bucket_of(x[i], boundaries, count);
+    }
+}
+
+#if VECTOR_DISPATCH_X86
+VECTOR_TARGET_AVX2 inline void histogram_bins_f32_avx2(const float* x, size_t n, float lo, float hi, float scale, uint32_t bins,
+                                                        uint32_t* out) {
+    __m256 vlo = _mm256_set1_ps(lo);
+    __m256 vhi = _mm256_set1_ps(hi);
+    __m256 vscale = _mm256_set1_ps(scale);
+    __m256i last = _mm256_set1_epi32(static_cast<int>(bins - 1));
+    __m256i drop = _mm256_set1_epi32(static_cast<int>(bins));
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(x + i);
+        __m256 in = _mm256_and_ps(_mm256_cmp_ps(v, vlo, _CMP_GE_OQ), _mm256_cmp_ps(v, vhi, _CMP_LE_OQ));
+        __m256i bin = _mm256_min_epu32(_mm256_cvttps_epi32(_mm256_mul_ps(_mm256_sub_ps(v, vlo), vscale)), last);
+        bin = _mm256_blendv_epi8(drop, bin, _mm256_castps_si256(in));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), bin);
+    }
+    histogram_bins_scalar(x + i, n - i, lo, hi, scale, bins, out + i);
+}
+
+VECTOR_TARGET_AVX512 inline void histogram_bins_f32_avx512(const float* x, size_t n, float lo, float hi, float scale, uint32_t bins,
+                                                            uint32_t* out) {
+    __m512 vlo = _mm512_set1_ps(lo);
+    __m512 vhi = _mm512_set1_ps(hi);
+    __m512 vscale = _mm512_set1_ps(scale);
+    __m512i last = _mm512_set1_epi32(static_cast<int>(bins - 1));
+    __m512i drop = _mm512_set1_epi32(static_cast<int>(bins));
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 v = _mm512_loadu_ps(x + i);
+        __mmask16 in = _mm512_cmp_ps_mask(v, vlo, _CMP_GE_OQ) & _mm512_cmp_ps_mask(v, vhi, _CMP_LE_OQ);
+        __m512i bin = _mm512_min_epu32(_mm512_cvttps_epi32(_mm512_mul_ps(_mm512_sub_ps(v, vlo), vscale)), last);
+        _mm512_storeu_si512(out + i, _mm512_mask_blend_epi32(in, drop, bin));
+    }
+    histogram_bins_scalar(x + i, n - i, lo, hi, scale, bins, out + i);
+}
+
+// Few boundaries: count the ones each value is not below, eight values per compare. Many:
+// the branchless binary search of bucket_of() with one gather per step.
+VECTOR_TARGET_AVX2 inline void bucketize_f32_avx2(const float* x, size_t n, const float* boundaries, size_t count, uint16_t* out) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(x + i);
+        __m256i bucket = _mm256_setzero_si256();
+        if (count <= kBucketizeLinearMax) {
+            for (size_t j = 0; j < count; ++j) {
+                __m256 ge = _mm256_cmp_ps(v, _mm256_set1_ps(boundaries[j]), _CMP_NLT_UQ);
+                bucket = _mm256_sub_epi32(bucket, _mm256_castps_si256(ge));
+            }
+        } else {
+            for (size_t len = count; len > 1;) {
+                size_t half = len / 2;
+                __m256i probe = _mm256_add_epi32(bucket, _mm256_set1_epi32(static_cast<int>(half)));
+                __m256 ge = _mm256_cmp_ps(v, _mm256_i32gather_ps(boundaries, probe, 4), _CMP_NLT_UQ);
+                bucket = _mm256_blendv_epi8(bucket, probe, _mm256_castps_si256(ge));
+                len -= half;
+            }
+            __m256 ge = _mm256_cmp_ps(v, _mm256_i32gather_ps(boundaries, bucket, 4), _CMP_NLT_UQ);
+            bucket = _mm256_sub_epi32(bucket, _mm256_castps_si256(ge));
+        }
+        __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(bucket), _mm256_extracti128_si256(bucket, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+    }
+    bucketize_scalar(x + i, n - i, boundaries, count, out + i);
+}
+
+VECTOR_TARGET_AVX512 inline void bucketize_f32_avx512(const float* x, size_t n, const float* boundaries, size_t count, uint16_t* out) {
+    __m512i one = _mm512_set1_epi32(1);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 v = _mm512_loadu_ps(x + i);
+        __m512i bucket = _mm512_setzero_si512();
+        if (count <= kBucketizeLinearMax) {
+            for (size_t j = 0; j < count; ++j) {
+                __mmask16 ge = _mm512_cmp_ps_mask(v, _mm512_set1_ps(boundaries[j]), _CMP_NLT_UQ);
+                bucket = _mm512_mask_add_epi32(bucket, ge, bucket, one);
+            }
+        } else {
+            for (size_t len = count; len > 1;) {
+                size_t half = len / 2;
+                __m512i probe = _mm512_add_epi32(bucket, _mm512_set1_epi32(static_cast<int>(half)));
+                __mmask16 ge = _mm512_cmp_ps_mask(v, _mm512_i32gather_ps(probe, boundaries, 4), _CMP_NLT_UQ);
+                bucket = _mm512_mask_blend_epi32(ge, bucket, probe);
+                len -= half;
+            }
+            __mmask16 ge = _mm512_cmp_ps_mask(v, _mm512_i32gather_ps(bucket, boundaries, 4), _CMP_NLT_UQ);
+            bucket = _mm512_mask_add_epi32(bucket, ge, bucket, one);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_cvtepi32_epi16(bucket));
+    }
+    bucketize_scalar(x + i, n - i, boundaries, count, out + i);
+}
+#endif
+
+template <typename T>
+void histogram_bins(const T* x, size_t n, T lo, T hi, HistogramScale<T> scale, uint32_t bins, uint32_t* out) {
+#if VECTOR_DISPATCH_X86
+    if constexpr (std::is_same_v<T, float>) {
+        static const auto kernel =
+            select_kernel(&histogram_bins_scalar<float>, nullptr, &histogram_bins_f32_avx2, &histogram_bins_f32_avx512);
+        kernel(x, n, lo, hi, scale, bins, out);
+        return;
+    }
+#endif
+    histogram_bins_scalar(x, n, lo, hi, scale, bins, out);
+}
+
+template <typename T>
+void bucketize_range(const T* x, size_t n, const T* boundaries, size_t count, uint16_t* out) {
+#if VECTOR_DISPATCH_X86
+    if constexpr (std::is_same_v<T, float>) {
+        static const auto kernel = select_kernel(&bucketize_scalar<float>, nullptr, &bucketize_f32_avx2, &bucketize_f32_avx512);
+        kernel(x, n, boundaries, count, out);
+        return;
+    }
+#endif
+    bucketize_scalar(x, n, boundaries, count, out);
+}
+
+// Adds the histogram of x[0..n) to totals[0..bins). sub is scratch for kHistogramLanes rows of
+// bins + 1 counters (the extra one absorbs dropped values); uint32 counters are flushed to the
+// 64-bit totals well before they could overflow.
+template <typename T>
+void histogram_accumulate(const T* x, size_t n, T lo, T hi, HistogramScale<T> scale, uint32_t bins, uint32_t* sub, uint64_t* totals) {
+    size_t stride = static_cast<size_t>(bins) + 1;
+    std::fill(sub, sub + kHistogramLanes * stride, uint32_t(0));
+    uint32_t idx[kHistogramBlock];
+    size_t pending = 0;
+    auto flush = [&] {
+        for (size_t b = 0; b < bins; ++b) {
+            totals[b] += uint64_t(sub[b]) + sub[stride + b] + sub[2 * stride + b] + sub[3 * stride + b];
+        }
+        std::fill(sub, sub + kHistogramLanes * stride, uint32_t(0));
+        pending = 0;
+    };
+    for (size_t i = 0; i < n; i += kHistogramBlock) {
+        size_t m = std::min(kHistogramBlock, n - i);
+        histogram_bins(x + i, m, lo, hi, scale, bins, idx);
+        size_t j = 0;
+        for (; j + kHistogramLanes <= m; j += kHistogramLanes) {
+            ++sub[idx[j]];
+            ++sub[stride + idx[j + 1]];
+            ++sub[2 * stride + idx[j + 2]];
+            ++sub[3 * stride + idx[j + 3]];
+        }
+        for (; j < m; ++j) {
+            ++sub[idx[j]];
+        }
+        pending += m;
+        if (pending >= kHistogramFlush) {
+            flush();
+        }
+    }
+    flush();
+}
+
+inline size_t histogram_threads(size_t n, size_t threads) {
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    return std::max<size_t>(1, std::min(threads, n / kHistogramMinChunk));
+}
+
+// Runs f(t, begin, end) over threads contiguous chunks of [0, n), the last on the calling thread.
+template <typename F>
+void run_chunked(size_t n, size_t threads, F&& f) {
+    Vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    WorkerJoiner joiner{workers};
+    size_t per_thread = (n + threads - 1) / threads;
+    for (size_t t = 0; t + 1 < threads; ++t) {
+        workers.emplace_back([&f, t, per_thread, n] { f(t, t * per_thread, std::min(n, (t + 1) * per_thread)); });
+    }
+    f(threads - 1, (threads - 1) * per_thread, n);
+}
+
+} // namespace detail
+
+// Counts of values in bins equal-width bins over [lo, hi]; bin i covers
+// [lo + i * w, lo + (i + 1) * w) except that hi itself falls in the last bin. Values outside the
+// range and NaN are not counted. lo, hi and hi - lo must be finite. threads = 0 uses every
+// hardware thread for large inputs.
+template <typename T, typename Allocator>
+Vector<uint64_t> histogram(const Vector<T, Allocator>& values, size_t bins, T lo, T hi, size_t threads = 0) {
+    static_assert(std::is_arithmetic_v<T>, "histogram values must be arithmetic");
+    using S = detail::HistogramScale<T>;
+    if (bins == 0 || bins >= UINT32_MAX) {
+        VECTOR_THROW(std::invalid_argument("histogram bin count must be in [1, 2^32 - 1)"));
+    }
+    if (!(lo < hi)) {
+        VECTOR_THROW(std::invalid_argument("histogram range must satisfy lo < hi"));
+    }
+    S width = static_cast<S>(hi) - static_cast<S>(lo);
+    S scale = static_cast<S>(bins) / width;
+    if (!std::isfinite(width) || !std::isfinite(scale)) {
+        VECTOR_THROW(std::invalid_argument("histogram range and its width must be finite"));
+    }
+    uint32_t nbins = static_cast<uint32_t>(bins);
+    size_t n = values.size();
+    threads = detail::histogram_threads(n, threads);
+    size_t stride = bins + 1;
+    Vector<uint32_t> scratch(threads * detail::kHistogramLanes * stride);
+    Vector<uint64_t> partial(threads * bins, 0);
+    detail::run_chunked(n, threads, [&](size_t t, size_t begin, size_t end) {
+        detail::histogram_accumulate(values.data() + begin, end - begin, lo, hi, scale, nbins,
+                                     scratch.data() + t * detail::kHistogramLanes * stride, partial.data() + t * bins);
+    });
+    Vector<uint64_t> counts(bins, 0);
+    for (size_t t = 0; t < threads; ++t) {
+        for (size_t b = 0; b < bins; ++b) {
+            counts[b] += partial[t * bins + b];
+        }
+    }
+    return counts;
+}
+
+// As above over [min, max] of the finite values; NaN and infinities are not counted. If they are
+// all equal, everything lands in bin 0; an input without finite values gives all-zero counts.
+// Throws like the overload above when max - min overflows.
+template <typename T, typename Allocator>
+Vector<uint64_t> histogram(const Vector<T, Allocator>& values, size_t bins, size_t threads = 0) {
+    T lo = std::numeric_limits<T>::max();
+    T hi = std::numeric_limits<T>::lowest();
+    for (size_t i = 0; i < values.size(); ++i) {
+        T v = values[i];
+        if constexpr (std::is_floating_point_v<T>) {
+            if (!std::isfinite(v)) {
+                continue;
+            }
+        }
+        lo = v < lo ? v : lo;
+        hi = v > hi ? v : hi;
+    }
+    if (lo > hi) {
+        return histogram(values, bins, T(0), T(1), threads);
+    }
+    if (!(lo < hi)) {
+        if (bins == 0 || bins >= UINT32_MAX) {
+            VECTOR_THROW(std::invalid_argument("histogram bin count must be in [1, 2^32 - 1)"));
+        }
+        Vector<uint64_t> counts(bins, 0);
+        for (size_t i = 0; i < values.size(); ++i) {
+            counts[0] += values[i] == lo;
+        }
+        return counts;
+    }
+    return histogram(values, bins, lo, hi, threads);
+}
+
+// For each value, the number of boundaries not greater than it: bucket 0 is below
+// boundaries[0] and bucket boundaries.size() is at or above the last one (NaN goes there too,
+// as with std::upper_bound). boundaries must be sorted ascending and hold at most 65535 entries.
+template <typename T, typename Allocator, typename BoundaryAllocator>
+Vector<uint16_t> bucketize(const Vector<T, Allocator>& values, const Vector<T, BoundaryAllocator>& boundaries, size_t threads = 0) {
+    static_assert(std::is_arithmetic_v<T>, "bucketize values must be arithmetic");
+    if (boundaries.size() > UINT16_MAX) {
+        VECTOR_THROW(std::length_error("bucketize supports at most 65535 boundaries"));
+    }
+    if (!std::is_sorted(boundaries.data(), boundaries.data() + boundaries.size())) {
+        VECTOR_THROW(std::invalid_argument("bucketize boundaries must be sorted"));
+    }
+    Vector<uint16_t> out;
+    out.resize_for_overwrite(values.size());
+    if (boundaries.empty()) {
+        std::fill(out.data(), out.data() + out.size(), uint16_t(0));
+        return out;
+    }
+    size_t n = values.size();
+    detail::run_chunked(n, detail::histogram_threads(n, threads), [&](size_t, size_t begin, size_t end) {
+        detail::bucketize_range(values.data() + begin, end - begin, boundaries.data(), boundaries.size(), out.data() + begin);
+    });
+    return out;
+}
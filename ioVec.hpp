@@ -0,0 +1,208 @@
+#pragma once
+
+#include "customVector.hpp"
+#include "byteBuffer.hpp"
+#include <cerrno>
+#include <climits>
+#include <system_error>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace detail {
+
+inline size_t iov_max() {
+#if defined(IOV_MAX)
+    return IOV_MAX;
+#else
+    long limit = ::sysconf(_SC_IOV_MAX);
+    return limit > 0 ? static_cast<size_t>(limit) : 16;
+#endif
+}
+
+inline bool io_would_block(int err) {
+    return err == EAGAIN || err == EWOULDBLOCK;
+}
+
+} // namespace detail
+
+// Gathers byte ranges from many Vectors/ByteBuffers and sends them with writev, without first
+// concatenating them. The referenced storage must stay alive and unmodified until done().
+class IoVecBuilder {
+public:
+    void add(const void* data, size_t n) {
+        if (n == 0) {
+            return;
+        }
+        iovec entry;
+        entry.iov_base = const_cast<void*>(data);
+        entry.iov_len = n;
+        iov_.push_back(entry);
+        remaining_ += n;
+    }
+
+    template <typename T, typename Allocator>
+    void add(const Vector<T, Allocator>& vec) {
+        static_assert(std::is_trivially_copyable_v<T>, "IoVecBuilder sends raw element bytes");
+        add(vec.data(), vec.size() * sizeof(T));
+    }
+
+    void add(const ByteBuffer& buffer) { add(buffer.data(), buffer.size()); }
+
+    size_t count() const { return iov_.size() - first_; }
+    size_t remaining_bytes() const { return remaining_; }
+    bool done() const { return remaining_ == 0; }
+
+    void clear() {
+        iov_.clear();
+        first_ = 0;
+        remaining_ = 0;
+    }
+
+    // One writev of at most IOV_MAX entries. Returns the bytes written, 0 if the descriptor is
+    // non-blocking and not ready. A partial write advances into the middle of an entry, so the
+    // next call resumes exactly where this one stopped.
+    size_t write_some(int fd) {
+        if (done()) {
+            return 0;
+        }
+        int entries = static_cast<int>(std::min(count(), detail::iov_max()));
+        ssize_t written;
+        do {
+            written = ::writev(fd, iov_.data() + first_, entries);
+        } while (written < 0 && errno == EINTR);
+        if (written < 0) {
+            if (detail::io_would_block(errno)) {
+                return 0;
+            }
+            VECTOR_THROW(std::system_error(errno, std::generic_category(), "writev"));
+        }
+        consume(static_cast<size_t>(written));
+        return static_cast<size_t>(written);
+    }
+
+    // Writes everything, for blocking descriptors.
+    size_t write_all(int fd) {
+        size_t total = 0;
+        while (!done()) {
+            total += write_some(fd);
+        }
+        return total;
+    }
+
+private:
+    Vector<iovec> iov_;
+    size_t first_ = 0;
+    size_t remaining_ = 0;
+
+    void consume(size_t n) {
+        remaining_ -= n;
+        while (n > 0) {
+            iovec& entry = iov_[first_];
+            if (n < entry.iov_len) {
+                entry.iov_base = static_cast<char*>(entry.iov_base) + n;
+                entry.iov_len -= n;
+                return;
+            }
+            n -= entry.iov_len;
+            ++first_;
+        }
+    }
+};
+
+// Scatter-read into the spare capacity of several byte Vectors/ByteBuffers with one readv.
+// Each target grows by at most its requested amount and keeps only what was actually read.
+// Add each target at most once per read.
+class IoVecReader {
+public:
+    template <typename T, typename Allocator>
+    void add(Vector<T, Allocator>& vec, size_t max_bytes) {
+        static_assert(sizeof(T) == 1 && std::is_trivial_v<T>, "IoVecReader targets must be byte Vectors");
+        Target target;
+        target.object = &vec;
+        target.max_bytes = max_bytes;
+        target.prepare = [](void* object, size_t n) -> uint8_t* {
+            auto& v = *static_cast<Vector<T, Allocator>*>(object);
+            size_t old = v.size();
+            v.resize_for_overwrite(old + n);
+            return reinterpret_cast<uint8_t*>(v.data() + old);
+        };
+        target.commit = [](void* object, uint8_t* start, size_t unused) {
+            auto& v = *static_cast<Vector<T, Allocator>*>(object);
+            (void)start;
+            v.resize(v.size() - unused);
+        };
+        targets_.push_back(target);
+    }
+
+    void add(ByteBuffer& buffer, size_t max_bytes) {
+        Target target;
+        target.object = &buffer;
+        target.max_bytes = max_bytes;
+        target.prepare = [](void* object, size_t n) -> uint8_t* {
+            return static_cast<ByteBuffer*>(object)->begin_write(n).position();
+        };
+        target.commit = [](void* object, uint8_t* start, size_t unused) {
+            (void)unused;
+            static_cast<ByteBuffer*>(object)->end_write(UncheckedWriter(start));
+        };
+        targets_.push_back(target);
+    }
+
+    size_t count() const { return targets_.size(); }
+    void clear() { targets_.clear(); }
+
+    // One readv across the first IOV_MAX targets, which are then removed; any further targets
+    // wait for the next call. Returns the bytes read (0 at end of file or when a non-blocking
+    // descriptor has nothing ready).
+    size_t read_from(int fd) {
+        size_t entries = std::min(targets_.size(), detail::iov_max());
+        Vector<iovec> iov(entries);
+        for (size_t i = 0; i < entries; ++i) {
+            iov[i].iov_base = targets_[i].prepare(targets_[i].object, targets_[i].max_bytes);
+            iov[i].iov_len = targets_[i].max_bytes;
+        }
+        ssize_t got;
+        do {
+            got = ::readv(fd, iov.data(), static_cast<int>(entries));
+        } while (got < 0 && errno == EINTR);
+        int err = errno;
+        size_t left = got > 0 ? static_cast<size_t>(got) : 0;
+        for (size_t i = 0; i < entries; ++i) {
+            size_t used = std::min(left, iov[i].iov_len);
+            left -= used;
+            targets_[i].commit(targets_[i].object, static_cast<uint8_t*>(iov[i].iov_base) + used, iov[i].iov_len - used);
+        }
+        Vector<Target> rest;
+        for (size_t i = entries; i < targets_.size(); ++i) {
+            rest.push_back(targets_[i]);
+        }
+        targets_ = std::move(rest);
+        if (got < 0 && !detail::io_would_block(err)) {
+            VECTOR_THROW(std::system_error(err, std::generic_category(), "readv"));
+        }
+        return got > 0 ? static_cast<size_t>(got) : 0;
+    }
+
+private:
+    struct Target {
+        void* object;
+        size_t max_bytes;
+        uint8_t* (*prepare)(void*, size_t);
+        void (*commit)(void*, uint8_t*, size_t);
+    };
+
+    Vector<Target> targets_;
+};
+
+// Reads up to max_bytes from fd straight into vec's spare capacity, appending what arrives.
+template <typename T, typename Allocator>
+size_t read_into(int fd, Vector<T, Allocator>& vec, size_t max_bytes) {
+    IoVecReader reader;
+    reader.add(vec, max_bytes);
+    return reader.read_from(fd);
+}
+
+#endif
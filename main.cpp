@@ -1,4 +1,5 @@
 #include "customVector.hpp"
+#include "formatVector.hpp"
 #include <iostream>
 #include <vector>
 int main() {
@@ -32,5 +33,14 @@ int main() {
     v.shrink_to_fit();
     std::cout << "After shrink_to_fit: Size: " << v.size() << ", Capacity: " << v.capacity() << "\n";
 
+    // Example 4: Formatting into a reusable buffer and writing it in one call
+    Vector<char> text;
+    FormatSpec spec;
+    spec.prefix = "Formatted: [";
+    spec.separator = ", ";
+    spec.suffix = "]\n";
+    format_to(text, v, spec);
+    std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+
     return 0;
 }
@@ -0,0 +1,279 @@
+#pragma once
+
+#include "customVector.hpp"
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+enum class Layout { RowMajor, ColMajor };
+
+constexpr size_t kCacheLineSize = 64;
+
+template <typename T, size_t Rank>
+class TensorView {
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using index_type = size_t;
+    using extents_type = std::array<size_t, Rank>;
+    using strides_type = std::array<std::ptrdiff_t, Rank>;
+
+    TensorView() : data_(nullptr), extents_{}, strides_{} {}
+    TensorView(T* data, const extents_type& extents, const strides_type& strides)
+        : data_(data), extents_(extents), strides_(strides) {}
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    TensorView(const TensorView<U, Rank>& other)
+        : data_(other.data_handle()), extents_(other.extents()), strides_(other.strides()) {}
+
+    static constexpr size_t rank() noexcept { return Rank; }
+    size_t extent(size_t r) const { return extents_[r]; }
+    std::ptrdiff_t stride(size_t r) const { return strides_[r]; }
+    const extents_type& extents() const { return extents_; }
+    const strides_type& strides() const { return strides_; }
+    T* data_handle() const noexcept { return data_; }
+
+    size_t size() const {
+        size_t n = 1;
+        for (size_t r = 0; r < Rank; ++r) {
+            n *= extents_[r];
+        }
+        return n;
+    }
+    bool empty() const { return size() == 0; }
+
+    bool is_contiguous() const {
+        std::ptrdiff_t expected = 1;
+        for (size_t r = Rank; r-- > 0;) {
+            if (extents_[r] != 1 && strides_[r] != expected) {
+                return false;
+            }
+            expected *= static_cast<std::ptrdiff_t>(extents_[r]);
+        }
+        return true;
+    }
+
+    template <typename... Idx>
+    T& operator()(Idx... idx) const {
+        static_assert(sizeof...(Idx) == Rank, "TensorView index count must match rank");
+        std::array<size_t, Rank> indices{static_cast<size_t>(idx)...};
+        std::ptrdiff_t offset = 0;
+        for (size_t r = 0; r < Rank; ++r) {
+            offset += static_cast<std::ptrdiff_t>(indices[r]) * strides_[r];
+        }
+        return data_[offset];
+    }
+
+    template <typename... Idx>
+    T& at(Idx... idx) const {
+        std::array<size_t, Rank> indices{static_cast<size_t>(idx)...};
+        for (size_t r = 0; r < Rank; ++r) {
+            if (indices[r] >= extents_[r]) {
+                VECTOR_THROW(std::out_of_range("TensorView index out of range"));
+            }
+        }
+        return (*this)(idx...);
+    }
+
+    TensorView slice(size_t dim, size_t first, size_t last, size_t step = 1) const {
+        if (dim >= Rank || first > last || last > extents_[dim] || step == 0) {
+            VECTOR_THROW(std::out_of_range("TensorView slice out of range"));
+        }
+        TensorView result = *this;
+        result.data_ = data_ + static_cast<std::ptrdiff_t>(first) * strides_[dim];
+        result.extents_[dim] = (last - first + step - 1) / step;
+        result.strides_[dim] = strides_[dim] * static_cast<std::ptrdiff_t>(step);
+        return result;
+    }
+
+    TensorView transposed(size_t d0, size_t d1) const {
+        if (d0 >= Rank || d1 >= Rank) {
+            VECTOR_THROW(std::out_of_range("TensorView transpose axis out of range"));
+        }
+        TensorView result = *this;
+        std::swap(result.extents_[d0], result.extents_[d1]);
+        std::swap(result.strides_[d0], result.strides_[d1]);
+        return result;
+    }
+
+    template <size_t R = Rank, typename = std::enable_if_t<(R > 1)>>
+    TensorView<T, Rank - 1> subview(size_t dim, size_t index) const {
+        if (dim >= Rank || index >= extents_[dim]) {
+            VECTOR_THROW(std::out_of_range("TensorView subview out of range"));
+        }
+        std::array<size_t, Rank - 1> extents{};
+        std::array<std::ptrdiff_t, Rank - 1> strides{};
+        for (size_t r = 0, k = 0; r < Rank; ++r) {
+            if (r != dim) {
+                extents[k] = extents_[r];
+                strides[k] = strides_[r];
+                ++k;
+            }
+        }
+        return TensorView<T, Rank - 1>(data_ + static_cast<std::ptrdiff_t>(index) * strides_[dim], extents, strides);
+    }
+
+private:
+    T* data_;
+    extents_type extents_;
+    strides_type strides_;
+};
+
+template <typename T>
+using MatrixView = TensorView<T, 2>;
+
+template <typename T>
+size_t padded_leading_dimension(size_t n) {
+    if (sizeof(T) >= kCacheLineSize || kCacheLineSize % sizeof(T) != 0) {
+        return n;
+    }
+    constexpr size_t per_line = kCacheLineSize / sizeof(T);
+    return (n + per_line - 1) / per_line * per_line;
+}
+
+template <typename T, typename Allocator = SimpleAllocator<T>>
+class Matrix {
+public:
+    Matrix() : rows_(0), cols_(0), ld_(0), offset_(0), layout_(Layout::RowMajor) {}
+
+    Matrix(size_t rows, size_t cols, Layout layout = Layout::RowMajor)
+        : Matrix(rows, cols, T(), layout) {}
+
+    Matrix(size_t rows, size_t cols, const T& value, Layout layout = Layout::RowMajor)
+        : rows_(rows), cols_(cols), offset_(0), layout_(layout) {
+        size_t inner = (layout == Layout::RowMajor) ? cols : rows;
+        size_t outer = (layout == Layout::RowMajor) ? rows : cols;
+        ld_ = padded_leading_dimension<T>(inner);
+        // The allocator need not return cache-line aligned memory, so whenever T packs evenly into
+        // a line, up to one line of slack is reserved and data() starts at the first aligned element.
+        bool line_aligned = sizeof(T) < kCacheLineSize && kCacheLineSize % sizeof(T) == 0;
+        size_t slack = (line_aligned && outer > 0) ? kCacheLineSize / sizeof(T) - 1 : 0;
+        storage_.resize(ld_ * outer + slack, value);
+        if (slack > 0) {
+            auto addr = reinterpret_cast<std::uintptr_t>(storage_.data());
+            size_t misalign = addr % kCacheLineSize;
+            if (misalign != 0 && misalign % sizeof(T) == 0) {
+                offset_ = (kCacheLineSize - misalign) / sizeof(T);
+            }
+        }
+    }
+
+    Matrix(const Matrix& other) : Matrix(other.rows_, other.cols_, other.layout_) {
+        copy(other.view(), view());
+    }
+
+    Matrix(Matrix&&) noexcept = default;
+
+    Matrix& operator=(const Matrix& other) {
+        Matrix tmp(other);
+        *this = std::move(tmp);
+        return *this;
+    }
+
+    Matrix& operator=(Matrix&&) noexcept = default;
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    size_t leading_dimension() const { return ld_; }
+    Layout layout() const { return layout_; }
+
+    T* data() noexcept { return storage_.data() + offset_; }
+    const T* data() const noexcept { return storage_.data() + offset_; }
+
+    T& operator()(size_t i, size_t j) { return data()[index_of(i, j)]; }
+    const T& operator()(size_t i, size_t j) const { return data()[index_of(i, j)]; }
+
+    T& at(size_t i, size_t j) {
+        check_index(i, j);
+        return (*this)(i, j);
+    }
+    const T& at(size_t i, size_t j) const {
+        check_index(i, j);
+        return (*this)(i, j);
+    }
+
+    MatrixView<T> view() { return MatrixView<T>(data(), {rows_, cols_}, strides()); }
+    MatrixView<const T> view() const { return MatrixView<const T>(data(), {rows_, cols_}, strides()); }
+
+    MatrixView<T> block(size_t row, size_t col, size_t nrows, size_t ncols) {
+        return view().slice(0, row, row + nrows).slice(1, col, col + ncols);
+    }
+    MatrixView<const T> block(size_t row, size_t col, size_t nrows, size_t ncols) const {
+        return view().slice(0, row, row + nrows).slice(1, col, col + ncols);
+    }
+
+    Matrix transposed() const {
+        Matrix result(cols_, rows_, layout_);
+        transpose(view(), result.view());
+        return result;
+    }
+
+private:
+    Vector<T, Allocator> storage_;
+    size_t rows_;
+    size_t cols_;
+    size_t ld_;
+    size_t offset_;
+    Layout layout_;
+
+    size_t index_of(size_t i, size_t j) const {
+        return (layout_ == Layout::RowMajor) ? i * ld_ + j : j * ld_ + i;
+    }
+
+    std::array<std::ptrdiff_t, 2> strides() const {
+        auto ld = static_cast<std::ptrdiff_t>(ld_);
+        if (layout_ == Layout::RowMajor) {
+            return {ld, 1};
+        }
+        return {1, ld};
+    }
+
+    void check_index(size_t i, size_t j) const {
+        if (i >= rows_ || j >= cols_) {
+            VECTOR_THROW(std::out_of_range("Matrix index out of range"));
+        }
+    }
+};
+
+template <typename T>
+constexpr size_t transpose_block_size() {
+    return (sizeof(T) >= kCacheLineSize) ? 4 : 2 * kCacheLineSize / sizeof(T);
+}
+
+template <typename T, typename U>
+void copy(const MatrixView<T>& src, const MatrixView<U>& dst) {
+    if (src.extent(0) != dst.extent(0) || src.extent(1) != dst.extent(1)) {
+        VECTOR_THROW(std::invalid_argument("Matrix copy shape mismatch"));
+    }
+    size_t rows = src.extent(0);
+    size_t cols = src.extent(1);
+    if (src.stride(1) == 1 && dst.stride(1) == 1) {
+        for (size_t i = 0; i < rows; ++i) {
+            std::copy(&src(i, 0), &src(i, 0) + cols, &dst(i, 0));
+        }
+        return;
+    }
+    if (src.stride(0) == 1 && dst.stride(0) == 1) {
+        for (size_t j = 0; j < cols; ++j) {
+            std::copy(&src(0, j), &src(0, j) + rows, &dst(0, j));
+        }
+        return;
+    }
+    constexpr size_t B = transpose_block_size<std::remove_cv_t<T>>();
+    for (size_t ii = 0; ii < rows; ii += B) {
+        size_t i_end = std::min(ii + B, rows);
+        for (size_t jj = 0; jj < cols; jj += B) {
+            size_t j_end = std::min(jj + B, cols);
+            for (size_t i = ii; i < i_end; ++i) {
+                for (size_t j = jj; j < j_end; ++j) {
+                    dst(i, j) = src(i, j);
+                }
+            }
+        }
+    }
+}
+
+template <typename T, typename U>
+void transpose(const MatrixView<T>& src, const MatrixView<U>& dst) {
+    copy(src.transposed(0, 1), dst);
+}
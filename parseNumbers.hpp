@@ -0,0 +1,260 @@
+#pragma once
+
+#include "customVector.hpp"
+#include "simd.hpp"
+#include "workerJoiner.hpp"
+#include <charconv>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+namespace detail {
+
+inline bool is_separator(char c, char delim) {
+    return c == delim || c == '\n' || c == '\r';
+}
+
+inline bool is_blank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+inline const char* find_separator_scalar(const char* p, const char* end, char delim) {
+    while (p < end && !is_separator(*p, delim)) {
+        ++p;
+    }
+    return p;
+}
+
+inline size_t count_separators_scalar(const char* p, const char* end, char delim) {
+    size_t count = 0;
+    for (; p < end; ++p) {
+        count += is_separator(*p, delim) ? 1 : 0;
+    }
+    return count;
+}
+
+#if VECTOR_DISPATCH_X86
+VECTOR_TARGET_SSE42 inline uint32_t separator_mask16(const char* p, char delim) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(delim)),
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'))));
+    return static_cast<uint32_t>(_mm_movemask_epi8(hits));
+}
+
+VECTOR_TARGET_AVX2 inline uint32_t separator_mask32(const char* p, char delim) {
+    __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(delim)),
+        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r'))));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+}
+
+VECTOR_TARGET_AVX512 inline uint64_t separator_mask64(const char* p, char delim) {
+    __m512i chunk = _mm512_loadu_si512(p);
+    return _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8(delim)) | _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\n'))
+        | _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\r'));
+}
+
+VECTOR_TARGET_SSE42 inline const char* find_separator_sse42(const char* p, const char* end, char delim) {
+    for (; p + 16 <= end; p += 16) {
+        if (uint32_t mask = separator_mask16(p, delim)) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return find_separator_scalar(p, end, delim);
+}
+
+VECTOR_TARGET_AVX2 inline const char* find_separator_avx2(const char* p, const char* end, char delim) {
+    for (; p + 32 <= end; p += 32) {
+        if (uint32_t mask = separator_mask32(p, delim)) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return find_separator_scalar(p, end, delim);
+}
+
+VECTOR_TARGET_AVX512 inline const char* find_separator_avx512(const char* p, const char* end, char delim) {
+    for (; p + 64 <= end; p += 64) {
+        if (uint64_t mask = separator_mask64(p, delim)) {
+            return p + __builtin_ctzll(mask);
+        }
+    }
+    return find_separator_scalar(p, end, delim);
+}
+
+VECTOR_TARGET_SSE42 inline size_t count_separators_sse42(const char* p, const char* end, char delim) {
+    size_t count = 0;
+    for (; p + 16 <= end; p += 16) {
+        count += static_cast<size_t>(__builtin_popcount(separator_mask16(p, delim)));
+    }
+    return count + count_separators_scalar(p, end, delim);
+}
+
+VECTOR_TARGET_AVX2 inline size_t count_separators_avx2(const char* p, const char* end, char delim) {
+    size_t count = 0;
+    for (; p + 32 <= end; p += 32) {
+        count += static_cast<size_t>(__builtin_popcount(separator_mask32(p, delim)));
+    }
+    return count + count_separators_scalar(p, end, delim);
+}
+
+VECTOR_TARGET_AVX512 inline size_t count_separators_avx512(const char* p, const char* end, char delim) {
+    size_t count = 0;
+    for (; p + 64 <= end; p += 64) {
+        count += static_cast<size_t>(__builtin_popcountll(separator_mask64(p, delim)));
+    }
+    return count + count_separators_scalar(p, end, delim);
+}
+#endif
+
+// Returns the first separator (delim, '\n' or '\r') in [p, end), or end.
+inline const char* find_separator(const char* p, const char* end, char delim) {
+#if VECTOR_DISPATCH_X86
+    static const auto kernel = select_kernel(&find_separator_scalar, &find_separator_sse42, &find_separator_avx2,
+                                             &find_separator_avx512);
+    return kernel(p, end, delim);
+#else
+    return find_separator_scalar(p, end, delim);
+#endif
+}
+
+// Upper bound on the number of fields: one more than the number of separators.
+inline size_t count_separators(const char* p, const char* end, char delim) {
+#if VECTOR_DISPATCH_X86
+    static const auto kernel = select_kernel(&count_separators_scalar, &count_separators_sse42, &count_separators_avx2,
+                                             &count_separators_avx512);
+    return kernel(p, end, delim);
+#else
+    return count_separators_scalar(p, end, delim);
+#endif
+}
+
+template <typename T>
+bool parse_field(const char* first, const char* last, T& value) {
+    while (first < last && is_blank(*first)) {
+        ++first;
+    }
+    while (last > first && is_blank(last[-1])) {
+        --last;
+    }
+    if (first < last && *first == '+') {
+        ++first;
+        // from_chars would take the '-' of "+-5" as the number's own sign.
+        if (first < last && *first == '-') {
+            return false;
+        }
+    }
+    std::from_chars_result result;
+    if constexpr (std::is_floating_point_v<T>) {
+        result = std::from_chars(first, last, value, std::chars_format::general);
+    } else {
+        result = std::from_chars(first, last, value);
+    }
+    return result.ec == std::errc() && result.ptr == last;
+}
+
+inline bool is_blank_field(const char* first, const char* last) {
+    while (first < last && is_blank(*first)) {
+        ++first;
+    }
+    return first == last;
+}
+
+} // namespace detail
+
+namespace detail {
+
+// parse_numbers() over text that starts base_offset bytes into the caller's input, so error
+// offsets count from the start of that input.
+template <typename T, typename Allocator>
+size_t parse_numbers_at(std::string_view text, Vector<T, Allocator>& out, char delim, size_t base_offset) {
+    (void)base_offset; // only read by the exception message, which -fno-exceptions builds drop
+    const char* p = text.data();
+    const char* end = p + text.size();
+    size_t before = out.size();
+    out.reserve(before + count_separators(p, end, delim) + 1);
+    while (p < end) {
+        const char* sep = find_separator(p, end, delim);
+        if (!is_blank_field(p, sep)) {
+            T value;
+            if (!parse_field(p, sep, value)) {
+                out.resize(before);
+                VECTOR_THROW(std::invalid_argument("parse_numbers: invalid number at offset "
+                    + std::to_string(base_offset + static_cast<size_t>(p - text.data())) + ": '" + std::string(p, sep) + "'"));
+            }
+            out.push_back(value);
+        }
+        p = (sep < end) ? sep + 1 : end;
+    }
+    return out.size() - before;
+}
+
+} // namespace detail
+
+// Parses delimiter- or newline-separated numbers from text and appends them to out. Blank fields
+// (empty lines, trailing delimiters) are skipped; anything else that is not a complete number
+// throws std::invalid_argument and leaves out unchanged. Returns the number of values appended.
+template <typename T, typename Allocator>
+size_t parse_numbers(std::string_view text, Vector<T, Allocator>& out, char delim = ',') {
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "parse_numbers requires a numeric element type");
+    return detail::parse_numbers_at(text, out, delim, 0);
+}
+
+// Splits text at separators into roughly equal chunks, parses each on its own thread and
+// appends the results to out in input order. As with parse_numbers(), a failed parse leaves out
+// unchanged.
+template <typename T, typename Allocator>
+size_t parse_numbers_parallel(std::string_view text, Vector<T, Allocator>& out, char delim = ',', size_t threads = 0) {
+    constexpr size_t kMinChunk = 1 << 16;
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, std::max<size_t>(1, text.size() / kMinChunk));
+    if (threads <= 1) {
+        return parse_numbers(text, out, delim);
+    }
+    Vector<std::string_view> chunks;
+    Vector<size_t> offsets;
+    size_t start = 0;
+    for (size_t t = 1; t <= threads && start < text.size(); ++t) {
+        size_t cut = (t == threads) ? text.size() : std::max(start, text.size() * t / threads);
+        const char* sep = detail::find_separator(text.data() + cut, text.data() + text.size(), delim);
+        size_t stop = static_cast<size_t>(sep - text.data());
+        chunks.push_back(text.substr(start, stop - start));
+        offsets.push_back(start);
+        start = stop + 1;
+    }
+    Vector<Vector<T>> parts(chunks.size());
+    Vector<std::exception_ptr> errors(chunks.size());
+    {
+        Vector<std::thread> workers;
+        workers.reserve(chunks.size());
+        detail::WorkerJoiner joiner{workers};
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            workers.emplace_back([&, i] {
+                VECTOR_TRY {
+                    detail::parse_numbers_at(chunks[i], parts[i], delim, offsets[i]);
+                } VECTOR_CATCH_ALL {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+    }
+    for (size_t i = 0; i < errors.size(); ++i) {
+        if (errors[i]) {
+            std::rethrow_exception(errors[i]);
+        }
+    }
+    size_t total = 0;
+    for (size_t i = 0; i < parts.size(); ++i) {
+        total += parts[i].size();
+    }
+    out.reserve(out.size() + total);
+    for (size_t i = 0; i < parts.size(); ++i) {
+        for (size_t j = 0; j < parts[i].size(); ++j) {
+            out.push_back(parts[i][j]);
+        }
+    }
+    return total;
+}
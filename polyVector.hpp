@@ -0,0 +1,355 @@
+#pragma once
+
+#include "customVector.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Polymorphic objects stored by value: each dynamic type gets its own contiguous segment (a
+// Vector<Derived>), so there is no allocation per object, and iteration walks one segment after
+// another. Within a segment every object has the same type, which keeps the indirect branch of a
+// virtual call perfectly predicted; for_each<D1, D2, ...>() goes further and hands the listed
+// types to the callback as D&. A virtual call through D& is still dispatched at run time, unless
+// D or the member function is final; then the compiler can call (and inline) it directly.
+//
+// Objects move when their segment grows or when erase() fills the hole with the segment's last
+// element, so references are invalidated by emplace/erase of the same type. Handles stay valid
+// until their own object is erased; a stale handle is detected by a per-slot generation.
+namespace detail {
+
+template <typename D>
+const void* poly_type_key() noexcept {
+    static const char key = 0;
+    return &key;
+}
+
+} // namespace detail
+
+template <typename Base>
+class PolyVector {
+public:
+    struct Handle {
+        uint32_t segment = UINT32_MAX;
+        uint32_t slot = 0;
+        uint32_t generation = 0;
+
+        bool operator==(const Handle& other) const noexcept {
+            return segment == other.segment && slot == other.slot && generation == other.generation;
+        }
+        bool operator!=(const Handle& other) const noexcept { return !(*this == other); }
+    };
+
+    PolyVector() = default;
+    PolyVector(PolyVector&&) noexcept = default;
+    PolyVector& operator=(PolyVector&&) noexcept = default;
+    PolyVector(const PolyVector&) = delete;
+    PolyVector& operator=(const PolyVector&) = delete;
+
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    size_t segment_count() const noexcept { return segments_.size(); }
+
+    template <typename D>
+    size_t size() const noexcept {
+        const SegmentBase* segment = find_segment(detail::poly_type_key<D>());
+        return segment ? segment->size() : 0;
+    }
+
+    template <typename D>
+    void reserve(size_t n) {
+        segment_for<D>().items.reserve(n);
+    }
+
+    template <typename D, typename... Args>
+    Handle emplace(Args&&... args) {
+        static_assert(std::is_base_of_v<Base, D>, "PolyVector elements must derive from Base");
+        static_assert(std::is_same_v<D, std::remove_cv_t<D>> && !std::is_reference_v<D>, "PolyVector element type must be unqualified");
+        static_assert(std::is_move_constructible_v<D> && std::is_move_assignable_v<D>,
+                      "PolyVector segments relocate and compact their elements");
+        uint32_t index = segment_index_for<D>();
+        auto& segment = static_cast<Segment<D>&>(*segments_[index]);
+        uint32_t slot = segment.acquire_slot();
+        VECTOR_TRY {
+            segment.items.emplace_back(std::forward<Args>(args)...);
+        }
+        VECTOR_CATCH_ALL {
+            segment.free_slots.push_back(slot);
+            VECTOR_RETHROW;
+        }
+        // The Base subobject sits at the same offset in every complete D, so measuring it on a
+        // live element also covers multiple and virtual inheritance.
+        D& added = segment.items.back();
+        segment.base_offset = reinterpret_cast<char*>(static_cast<Base*>(&added)) - reinterpret_cast<char*>(&added);
+        segment.bind(slot);
+        ++size_;
+        return Handle{index, slot, segment.slot_generation[slot]};
+    }
+
+    template <typename D>
+    Handle push_back(D&& value) {
+        return emplace<std::decay_t<D>>(std::forward<D>(value));
+    }
+
+    bool contains(Handle handle) const noexcept { return locate(handle) != kNoDense; }
+
+    // Null for a stale or foreign handle.
+    Base* get(Handle handle) noexcept { return const_cast<Base*>(std::as_const(*this).get(handle)); }
+
+    const Base* get(Handle handle) const noexcept {
+        size_t dense = locate(handle);
+        return dense == kNoDense ? nullptr : segments_[handle.segment]->base_at(dense);
+    }
+
+    Base& at(Handle handle) { return const_cast<Base&>(std::as_const(*this).at(handle)); }
+
+    const Base& at(Handle handle) const {
+        const Base* p = get(handle);
+        if (p == nullptr) {
+            VECTOR_THROW(std::out_of_range("PolyVector handle is stale"));
+        }
+        return *p;
+    }
+
+    // Typed access; null if the handle is stale or refers to another type.
+    template <typename D>
+    D* get_as(Handle handle) noexcept {
+        return const_cast<D*>(std::as_const(*this).template get_as<D>(handle));
+    }
+
+    template <typename D>
+    const D* get_as(Handle handle) const noexcept {
+        size_t dense = locate(handle);
+        if (dense == kNoDense || segments_[handle.segment]->key != detail::poly_type_key<D>()) {
+            return nullptr;
+        }
+        return static_cast<const Segment<D>&>(*segments_[handle.segment]).items.data() + dense;
+    }
+
+    // Destroys the object; the segment's last element is moved into its place. Returns false for
+    // a stale handle.
+    bool erase(Handle handle) {
+        size_t dense = locate(handle);
+        if (dense == kNoDense) {
+            return false;
+        }
+        segments_[handle.segment]->remove(dense);
+        --size_;
+        return true;
+    }
+
+    // Destroys every element; all handles become stale. Segments keep their capacity.
+    void clear() noexcept {
+        for (size_t s = 0; s < segments_.size(); ++s) {
+            segments_[s]->clear();
+        }
+        size_ = 0;
+    }
+
+    // Calls f(Base&) for every element, segment by segment. Elements are reached by stride from
+    // the segment's data, without a virtual call per element.
+    template <typename F>
+    void for_each(F&& f) {
+        for (size_t s = 0; s < segments_.size(); ++s) {
+            segments_[s]->template visit_base<Base>(f);
+        }
+    }
+
+    template <typename F>
+    void for_each(F&& f) const {
+        for (size_t s = 0; s < segments_.size(); ++s) {
+            static_cast<const SegmentBase&>(*segments_[s]).template visit_base<const Base>(f);
+        }
+    }
+
+    // As for_each(f), but elements of the listed types are passed as D&; other types are still
+    // passed as Base&. f is typically a generic lambda. Calls through D& are direct only for
+    // final types or members (or when f names D::member explicitly).
+    template <typename... Ds, typename F, std::enable_if_t<(sizeof...(Ds) > 0), int> = 0>
+    void for_each(F&& f) {
+        for (size_t s = 0; s < segments_.size(); ++s) {
+            if (!(visit_typed<Ds>(*segments_[s], f) || ...)) {
+                segments_[s]->template visit_base<Base>(f);
+            }
+        }
+    }
+
+    template <typename... Ds, typename F, std::enable_if_t<(sizeof...(Ds) > 0), int> = 0>
+    void for_each(F&& f) const {
+        for (size_t s = 0; s < segments_.size(); ++s) {
+            if (!(visit_typed<Ds>(static_cast<const SegmentBase&>(*segments_[s]), f) || ...)) {
+                static_cast<const SegmentBase&>(*segments_[s]).template visit_base<const Base>(f);
+            }
+        }
+    }
+
+private:
+    static constexpr size_t kNoDense = SIZE_MAX;
+
+    // Type-independent bookkeeping: slot -> dense position (for handles) and dense -> slot (to
+    // patch the moved element's slot on erase), plus what for_each needs to walk the items.
+    struct SegmentBase {
+        const void* key;
+        size_t stride;
+        ptrdiff_t base_offset = 0;
+        Vector<uint32_t> slot_dense;
+        Vector<uint32_t> slot_generation;
+        Vector<uint32_t> dense_slot;
+        Vector<uint32_t> free_slots;
+
+        SegmentBase(const void* type_key, size_t element_size) : key(type_key), stride(element_size) {}
+        virtual ~SegmentBase() = default;
+
+        virtual char* bytes() noexcept = 0;
+        virtual void move_last_to(size_t dense) = 0;
+        virtual void destroy_last() noexcept = 0;
+        virtual void destroy_all() noexcept = 0;
+
+        size_t size() const noexcept { return dense_slot.size(); }
+        const char* bytes() const noexcept { return const_cast<SegmentBase*>(this)->bytes(); }
+
+        // Reserves the bookkeeping entries for one more element so bind() cannot throw.
+        uint32_t acquire_slot() {
+            reserve_one(dense_slot);
+            if (free_slots.empty()) {
+                if (slot_dense.size() >= UINT32_MAX) {
+                    VECTOR_THROW(std::length_error("PolyVector segment is full"));
+                }
+                reserve_one(slot_generation);
+                slot_dense.push_back(0);
+                slot_generation.push_back(0);
+                return static_cast<uint32_t>(slot_dense.size() - 1);
+            }
+            uint32_t slot = free_slots.back();
+            free_slots.pop_back();
+            return slot;
+        }
+
+        static void reserve_one(Vector<uint32_t>& v) {
+            if (v.size() == v.capacity()) {
+                v.reserve(std::max<size_t>(8, v.capacity() * 2));
+            }
+        }
+
+        void bind(uint32_t slot) noexcept {
+            slot_dense[slot] = static_cast<uint32_t>(dense_slot.size());
+            dense_slot.push_back(slot);
+        }
+
+        Base* base_at(size_t dense) noexcept { return reinterpret_cast<Base*>(bytes() + dense * stride + base_offset); }
+        const Base* base_at(size_t dense) const noexcept {
+            return reinterpret_cast<const Base*>(bytes() + dense * stride + base_offset);
+        }
+
+        void remove(size_t dense) {
+            uint32_t slot = dense_slot[dense];
+            size_t last = dense_slot.size() - 1;
+            if (dense != last) {
+                move_last_to(dense);
+                uint32_t moved = dense_slot[last];
+                dense_slot[dense] = moved;
+                slot_dense[moved] = static_cast<uint32_t>(dense);
+            }
+            destroy_last();
+            dense_slot.pop_back();
+            ++slot_generation[slot];
+            free_slots.push_back(slot);
+        }
+
+        void clear() noexcept {
+            destroy_all();
+            for (size_t i = 0; i < dense_slot.size(); ++i) {
+                ++slot_generation[dense_slot[i]];
+            }
+            free_slots.clear();
+            for (size_t slot = slot_dense.size(); slot > 0; --slot) {
+                free_slots.push_back(static_cast<uint32_t>(slot - 1));
+            }
+            dense_slot.clear();
+        }
+
+        template <typename B, typename F>
+        void visit_base(F& f) {
+            char* p = bytes() + base_offset;
+            for (size_t i = 0, n = size(); i < n; ++i, p += stride) {
+                f(*reinterpret_cast<B*>(p));
+            }
+        }
+
+        template <typename B, typename F>
+        void visit_base(F& f) const {
+            const char* p = bytes() + base_offset;
+            for (size_t i = 0, n = size(); i < n; ++i, p += stride) {
+                f(*reinterpret_cast<B*>(p));
+            }
+        }
+    };
+
+    template <typename D>
+    struct Segment final : SegmentBase {
+        Vector<D> items;
+
+        Segment() : SegmentBase(detail::poly_type_key<D>(), sizeof(D)) {}
+
+        char* bytes() noexcept override { return reinterpret_cast<char*>(items.data()); }
+        void move_last_to(size_t dense) override { items[dense] = std::move(items.back()); }
+        void destroy_last() noexcept override { items.pop_back(); }
+        void destroy_all() noexcept override { items.clear(); }
+    };
+
+    Vector<std::unique_ptr<SegmentBase>> segments_;
+    size_t size_ = 0;
+
+    const SegmentBase* find_segment(const void* key) const noexcept {
+        for (size_t s = 0; s < segments_.size(); ++s) {
+            if (segments_[s]->key == key) {
+                return segments_[s].get();
+            }
+        }
+        return nullptr;
+    }
+
+    template <typename D>
+    uint32_t segment_index_for() {
+        const void* key = detail::poly_type_key<D>();
+        for (size_t s = 0; s < segments_.size(); ++s) {
+            if (segments_[s]->key == key) {
+                return static_cast<uint32_t>(s);
+            }
+        }
+        segments_.push_back(std::make_unique<Segment<D>>());
+        return static_cast<uint32_t>(segments_.size() - 1);
+    }
+
+    template <typename D>
+    Segment<D>& segment_for() {
+        return static_cast<Segment<D>&>(*segments_[segment_index_for<D>()]);
+    }
+
+    size_t locate(Handle handle) const noexcept {
+        if (handle.segment >= segments_.size()) {
+            return kNoDense;
+        }
+        const SegmentBase& segment = *segments_[handle.segment];
+        if (handle.slot >= segment.slot_dense.size() || segment.slot_generation[handle.slot] != handle.generation) {
+            return kNoDense;
+        }
+        size_t dense = segment.slot_dense[handle.slot];
+        return dense < segment.size() && segment.dense_slot[dense] == handle.slot ? dense : kNoDense;
+    }
+
+    template <typename D, typename S, typename F>
+    static bool visit_typed(S& segment, F& f) {
+        if (segment.key != detail::poly_type_key<D>()) {
+            return false;
+        }
+        using SegmentD = std::conditional_t<std::is_const_v<S>, const Segment<D>, Segment<D>>;
+        auto& items = static_cast<SegmentD&>(segment).items;
+        for (size_t i = 0; i < items.size(); ++i) {
+            f(items[i]);
+        }
+        return true;
+    }
+};
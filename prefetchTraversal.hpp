@@ -0,0 +1,138 @@
+#pragma once
+
+#include "customVector.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Traversals over Vectors of pointers or of indices into another Vector, for object graphs where
+// each element is a dependent load that misses cache. While element i is processed the target of
+// element i + distance is prefetched, so with a distance of roughly (miss latency / work per
+// element) the loads overlap instead of stalling one after another. A distance of 0 disables
+// prefetching; the default suits a few tens of nanoseconds of work per element.
+constexpr size_t kDefaultPrefetchDistance = 8;
+
+namespace detail {
+
+// Prefetches the cache lines of one object, capped at four lines so a large element does not
+// flood the fill buffers. Null pointers are skipped: offsetting one to reach its later lines
+// would be undefined, even though the prefetch itself could not fault.
+template <typename T>
+inline void prefetch_object(const T* p) {
+#if defined(__GNUC__)
+    if (p == nullptr) {
+        return;
+    }
+    constexpr size_t lines = std::min<size_t>(4, (sizeof(T) + 63) / 64);
+    const char* bytes = reinterpret_cast<const char*>(p);
+    for (size_t line = 0; line < lines; ++line) {
+        __builtin_prefetch(bytes + line * 64);
+    }
+#else
+    (void)p;
+#endif
+}
+
+template <typename Index>
+inline size_t checked_index(Index index, size_t size, const char* what) {
+    static_assert(std::is_integral_v<Index>, "indirect traversal indices must be integers");
+    if constexpr (std::is_signed_v<Index>) {
+        if (index < 0) {
+            VECTOR_THROW(std::out_of_range(what));
+        }
+    }
+    if (static_cast<size_t>(index) >= size) {
+        VECTOR_THROW(std::out_of_range(what));
+    }
+    return static_cast<size_t>(index);
+}
+
+// Drives both traversal shapes: target(i) yields the address element i refers to and visit(i)
+// does the work. The first `distance` targets are prefetched up front, then the main loop runs
+// branch-free until the prefetch window reaches the end.
+template <typename Target, typename Visit>
+inline void prefetched_loop(size_t n, size_t distance, Target&& target, Visit&& visit) {
+    if (distance == 0) {
+        for (size_t i = 0; i < n; ++i) {
+            visit(i);
+        }
+        return;
+    }
+    size_t warm = std::min(distance, n);
+    for (size_t i = 0; i < warm; ++i) {
+        prefetch_object(target(i));
+    }
+    size_t i = 0;
+    for (; i + distance < n; ++i) {
+        prefetch_object(target(i + distance));
+        visit(i);
+    }
+    for (; i < n; ++i) {
+        visit(i);
+    }
+}
+
+// Address of base[index] for prefetching only, or null when the index is out of range; the
+// range check of the visit itself happens when the element is reached.
+template <typename Index, typename T, typename Allocator>
+inline const T* prefetch_target(const Vector<T, Allocator>& base, Index index) {
+    if constexpr (std::is_signed_v<Index>) {
+        if (index < 0) {
+            return nullptr;
+        }
+    }
+    return static_cast<size_t>(index) < base.size() ? base.data() + static_cast<size_t>(index) : nullptr;
+}
+
+} // namespace detail
+
+// Calls f(p) for every pointer p in vec, in order, prefetching *vec[i + distance] beforehand.
+template <typename T, typename Allocator, typename F>
+void for_each_prefetched(const Vector<T*, Allocator>& vec, F&& f, size_t distance = kDefaultPrefetchDistance) {
+    T* const* ptrs = vec.data();
+    detail::prefetched_loop(vec.size(), distance, [&](size_t i) { return ptrs[i]; }, [&](size_t i) { f(ptrs[i]); });
+}
+
+// Calls f(base[i]) for every index i in indices, in order, prefetching base[indices[i + distance]].
+// Throws std::out_of_range on the first index outside base, after visiting the ones before it.
+template <typename Index, typename IndexAllocator, typename T, typename Allocator, typename F>
+void for_each_prefetched(const Vector<Index, IndexAllocator>& indices, Vector<T, Allocator>& base, F&& f,
+                         size_t distance = kDefaultPrefetchDistance) {
+    const Index* idx = indices.data();
+    detail::prefetched_loop(
+        indices.size(), distance, [&](size_t i) { return detail::prefetch_target(base, idx[i]); },
+        [&](size_t i) { f(base[detail::checked_index(idx[i], base.size(), "for_each_prefetched index out of range")]); });
+}
+
+template <typename Index, typename IndexAllocator, typename T, typename Allocator, typename F>
+void for_each_prefetched(const Vector<Index, IndexAllocator>& indices, const Vector<T, Allocator>& base, F&& f,
+                         size_t distance = kDefaultPrefetchDistance) {
+    const Index* idx = indices.data();
+    detail::prefetched_loop(
+        indices.size(), distance, [&](size_t i) { return detail::prefetch_target(base, idx[i]); },
+        [&](size_t i) { f(base[detail::checked_index(idx[i], base.size(), "for_each_prefetched index out of range")]); });
+}
+
+// Returns {f(ptrs[0]), f(ptrs[1]), ...}, prefetching the pointee distance elements ahead.
+template <typename T, typename Allocator, typename F>
+auto transform_indirect(const Vector<T*, Allocator>& ptrs, F&& f, size_t distance = kDefaultPrefetchDistance)
+    -> Vector<std::decay_t<std::invoke_result_t<F&, T*>>> {
+    Vector<std::decay_t<std::invoke_result_t<F&, T*>>> out;
+    out.reserve(ptrs.size());
+    for_each_prefetched(ptrs, [&](T* p) { out.push_back(f(p)); }, distance);
+    return out;
+}
+
+// Returns {f(base[indices[0]]), f(base[indices[1]]), ...}: a gather through an index Vector
+// (typically Vector<uint32_t> ids into a node table) with the same prefetching.
+template <typename Index, typename IndexAllocator, typename T, typename Allocator, typename F>
+auto transform_indirect(const Vector<Index, IndexAllocator>& indices, const Vector<T, Allocator>& base, F&& f,
+                        size_t distance = kDefaultPrefetchDistance)
+    -> Vector<std::decay_t<std::invoke_result_t<F&, const T&>>> {
+    Vector<std::decay_t<std::invoke_result_t<F&, const T&>>> out;
+    out.reserve(indices.size());
+    for_each_prefetched(indices, base, [&](const T& value) { out.push_back(f(value)); }, distance);
+    return out;
+}
@@ -0,0 +1,666 @@
+#pragma once
+
+#include "customVector.hpp"
+#include "simd.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace detail {
+
+inline uint32_t float_bits(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+inline float bits_float(uint32_t u) {
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+} // namespace detail
+
+struct HalfCodec {
+    static uint16_t encode(float f) {
+        uint32_t x = detail::float_bits(f);
+        uint32_t sign = x & 0x80000000u;
+        x ^= sign;
+        uint16_t out;
+        if (x >= (143u << 23)) {
+            out = (x > (255u << 23)) ? 0x7E00 : 0x7C00;
+        } else if (x < (113u << 23)) {
+            const uint32_t denorm_magic = 126u << 23;
+            float rounded = detail::bits_float(x) + detail::bits_float(denorm_magic);
+            out = static_cast<uint16_t>(detail::float_bits(rounded) - denorm_magic);
+        } else {
+            uint32_t mant_odd = (x >> 13) & 1u;
+            x -= 112u << 23;
+            x += 0xFFFu + mant_odd;
+            out = static_cast<uint16_t>(x >> 13);
+        }
+        return static_cast<uint16_t>(out | (sign >> 16));
+    }
+
+    static float decode(uint16_t h) {
+        uint32_t out = static_cast<uint32_t>(h & 0x7FFFu) << 13;
+        uint32_t exp = out & (0x1Fu << 23);
+        out += 112u << 23;
+        if (exp == (0x1Fu << 23)) {
+            out += 112u << 23;
+        } else if (exp == 0) {
+            out += 1u << 23;
+            out = detail::float_bits(detail::bits_float(out) - detail::bits_float(113u << 23));
+        }
+        out |= static_cast<uint32_t>(h & 0x8000u) << 16;
+        return detail::bits_float(out);
+    }
+
+#if VECTOR_DISPATCH_X86
+    VECTOR_TARGET_AVX2 static __m256 load8(const uint16_t* src) {
+        return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+    }
+
+    VECTOR_TARGET_AVX2 static void store8(uint16_t* dst, __m256 v) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+    }
+
+    VECTOR_TARGET_AVX512 static __m512 load16(const uint16_t* src) {
+        return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)));
+    }
+#endif
+};
+
+struct BFloat16Codec {
+    static uint16_t encode(float f) {
+        uint32_t x = detail::float_bits(f);
+        if ((x & 0x7FFFFFFFu) > 0x7F800000u) {
+            return static_cast<uint16_t>((x >> 16) | 0x40u);
+        }
+        x += 0x7FFFu + ((x >> 16) & 1u);
+        return static_cast<uint16_t>(x >> 16);
+    }
+
+    static float decode(uint16_t b) {
+        return detail::bits_float(static_cast<uint32_t>(b) << 16);
+    }
+
+#if VECTOR_DISPATCH_X86
+    VECTOR_TARGET_AVX2 static __m256 load8(const uint16_t* src) {
+        __m256i wide = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+        return _mm256_castsi256_ps(_mm256_slli_epi32(wide, 16));
+    }
+
+    VECTOR_TARGET_AVX2 static void store8(uint16_t* dst, __m256 v) {
+        __m256i x = _mm256_castps_si256(v);
+        __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(x, 16), _mm256_set1_epi32(1));
+        __m256i rounded = _mm256_add_epi32(x, _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7FFF)));
+        __m256i quiet = _mm256_or_si256(x, _mm256_set1_epi32(0x400000));
+        __m256i is_nan = _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+        rounded = _mm256_srli_epi32(_mm256_blendv_epi8(rounded, quiet, is_nan), 16);
+        __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(rounded), _mm256_extracti128_si256(rounded, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), packed);
+    }
+
+    VECTOR_TARGET_AVX512 static __m512 load16(const uint16_t* src) {
+        __m512i wide = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)));
+        return _mm512_castsi512_ps(_mm512_slli_epi32(wide, 16));
+    }
+#endif
+};
+
+namespace detail {
+
+template <typename Codec>
+void encode_batch_scalar(const float* src, uint16_t* dst, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = Codec::encode(src[i]);
+    }
+}
+
+template <typename Codec>
+void decode_batch_scalar(const uint16_t* src, float* dst, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = Codec::decode(src[i]);
+    }
+}
+
+template <typename Codec>
+float packed_sum_scalar(const uint16_t* a, size_t n) {
+    float total = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        total += Codec::decode(a[i]);
+    }
+    return total;
+}
+
+template <typename Codec>
+float packed_dot_scalar(const uint16_t* a, const uint16_t* b, size_t n) {
+    float total = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        total += Codec::decode(a[i]) * Codec::decode(b[i]);
+    }
+    return total;
+}
+
+template <typename Codec>
+float packed_dot_mixed_scalar(const uint16_t* a, const float* b, size_t n) {
+    float total = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        total += Codec::decode(a[i]) * b[i];
+    }
+    return total;
+}
+
+#if VECTOR_DISPATCH_X86
+template <typename Codec>
+VECTOR_TARGET_AVX2 void encode_batch_avx2(const float* src, uint16_t* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        Codec::store8(dst + i, _mm256_loadu_ps(src + i));
+    }
+    encode_batch_scalar<Codec>(src + i, dst + i, n - i);
+}
+
+template <typename Codec>
+VECTOR_TARGET_AVX2 void decode_batch_avx2(const uint16_t* src, float* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(dst + i, Codec::load8(src + i));
+    }
+    decode_batch_scalar<Codec>(src + i, dst + i, n - i);
+}
+
+template <typename Codec>
+VECTOR_TARGET_AVX2 float packed_sum_avx2(const uint16_t* a, size_t n) {
+    size_t i = 0;
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_add_ps(acc0, Codec::load8(a + i));
+        acc1 = _mm256_add_ps(acc1, Codec::load8(a + i + 8));
+    }
+    return hsum(_mm256_add_ps(acc0, acc1)) + packed_sum_scalar<Codec>(a + i, n - i);
+}
+
+template <typename Codec>
+VECTOR_TARGET_AVX2 float packed_dot_avx2(const uint16_t* a, const uint16_t* b, size_t n) {
+    size_t i = 0;
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(Codec::load8(a + i), Codec::load8(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(Codec::load8(a + i + 8), Codec::load8(b + i + 8), acc1);
+    }
+    return hsum(_mm256_add_ps(acc0, acc1)) + packed_dot_scalar<Codec>(a + i, b + i, n - i);
+}
+
+template <typename Codec>
+VECTOR_TARGET_AVX2 float packed_dot_mixed_avx2(const uint16_t* a, const float* b, size_t n) {
+    size_t i = 0;
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(Codec::load8(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(Codec::load8(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    return hsum(_mm256_add_ps(acc0, acc1)) + packed_dot_mixed_scalar<Codec>(a + i, b + i, n - i);
+}
+
+template <typename Codec>
+VECTOR_TARGET_AVX512 float packed_sum_avx512(const uint16_t* a, size_t n) {
+    size_t i = 0;
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm512_add_ps(acc0, Codec::load16(a + i));
+        acc1 = _mm512_add_ps(acc1, Codec::load16(a + i + 16));
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1)) + packed_sum_avx2<Codec>(a + i, n - i);
+}
+
+template <typename Codec>
+VECTOR_TARGET_AVX512 float packed_dot_avx512(const uint16_t* a, const uint16_t* b, size_t n) {
+    size_t i = 0;
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm512_fmadd_ps(Codec::load16(a + i), Codec::load16(b + i), acc0);
+        acc1 = _mm512_fmadd_ps(Codec::load16(a + i + 16), Codec::load16(b + i + 16), acc1);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1)) + packed_dot_avx2<Codec>(a + i, b + i, n - i);
+}
+
+template <typename Codec>
+VECTOR_TARGET_AVX512 float packed_dot_mixed_avx512(const uint16_t* a, const float* b, size_t n) {
+    size_t i = 0;
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm512_fmadd_ps(Codec::load16(a + i), _mm512_loadu_ps(b + i), acc0);
+        acc1 = _mm512_fmadd_ps(Codec::load16(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1)) + packed_dot_mixed_avx2<Codec>(a + i, b + i, n - i);
+}
+#endif
+
+} // namespace detail
+
+template <typename Codec>
+void encode_batch(const float* src, uint16_t* dst, size_t n) {
+#if VECTOR_DISPATCH_X86
+    static const auto kernel = select_kernel(&detail::encode_batch_scalar<Codec>, nullptr, &detail::encode_batch_avx2<Codec>, nullptr);
+    kernel(src, dst, n);
+#else
+    detail::encode_batch_scalar<Codec>(src, dst, n);
+#endif
+}
+
+template <typename Codec>
+void decode_batch(const uint16_t* src, float* dst, size_t n) {
+#if VECTOR_DISPATCH_X86
+    static const auto kernel = select_kernel(&detail::decode_batch_scalar<Codec>, nullptr, &detail::decode_batch_avx2<Codec>, nullptr);
+    kernel(src, dst, n);
+#else
+    detail::decode_batch_scalar<Codec>(src, dst, n);
+#endif
+}
+
+template <typename Codec>
+float packed_sum(const uint16_t* a, size_t n) {
+#if VECTOR_DISPATCH_X86
+    static const auto kernel = select_kernel(&detail::packed_sum_scalar<Codec>, nullptr, &detail::packed_sum_avx2<Codec>,
+                                             &detail::packed_sum_avx512<Codec>);
+    return kernel(a, n);
+#else
+    return detail::packed_sum_scalar<Codec>(a, n);
+#endif
+}
+
+template <typename Codec>
+float packed_dot(const uint16_t* a, const uint16_t* b, size_t n) {
+#if VECTOR_DISPATCH_X86
+    static const auto kernel = select_kernel(&detail::packed_dot_scalar<Codec>, nullptr, &detail::packed_dot_avx2<Codec>,
+                                             &detail::packed_dot_avx512<Codec>);
+    return kernel(a, b, n);
+#else
+    return detail::packed_dot_scalar<Codec>(a, b, n);
+#endif
+}
+
+template <typename Codec>
+float packed_dot(const uint16_t* a, const float* b, size_t n) {
+#if VECTOR_DISPATCH_X86
+    static const auto kernel = select_kernel(&detail::packed_dot_mixed_scalar<Codec>, nullptr, &detail::packed_dot_mixed_avx2<Codec>,
+                                             &detail::packed_dot_mixed_avx512<Codec>);
+    return kernel(a, b, n);
+#else
+    return detail::packed_dot_mixed_scalar<Codec>(a, b, n);
+#endif
+}
+
+template <typename Codec>
+class PackedFloatVector {
+public:
+    PackedFloatVector() = default;
+    explicit PackedFloatVector(const Vector<float>& values) { assign(values); }
+
+    size_t size() const { return bits_.size(); }
+    bool empty() const { return bits_.empty(); }
+    size_t capacity() const { return bits_.capacity(); }
+    void reserve(size_t n) { bits_.reserve(n); }
+    void clear() { bits_.clear(); }
+
+    void push_back(float value) { bits_.push_back(Codec::encode(value)); }
+
+    float operator[](size_t index) const { return Codec::decode(bits_[index]); }
+    float at(size_t index) const { return Codec::decode(bits_.at(index)); }
+    void set(size_t index, float value) { bits_[index] = Codec::encode(value); }
+
+    uint16_t* data() noexcept { return bits_.data(); }
+    const uint16_t* data() const noexcept { return bits_.data(); }
+    const Vector<uint16_t>& raw() const { return bits_; }
+
+    void assign(const Vector<float>& values) {
+        bits_.resize(values.size());
+        encode_batch<Codec>(values.data(), bits_.data(), values.size());
+    }
+
+    void append(const float* values, size_t n) {
+        size_t old_size = bits_.size();
+        bits_.resize(old_size + n);
+        encode_batch<Codec>(values, bits_.data() + old_size, n);
+    }
+
+    void to_float(Vector<float>& out) const {
+        out.resize(bits_.size());
+        decode_batch<Codec>(bits_.data(), out.data(), bits_.size());
+    }
+
+    Vector<float> to_vector() const {
+        Vector<float> out;
+        to_float(out);
+        return out;
+    }
+
+    float sum() const { return packed_sum<Codec>(bits_.data(), bits_.size()); }
+
+    float dot(const PackedFloatVector& other) const {
+        check_size(other.size());
+        return packed_dot<Codec>(bits_.data(), other.bits_.data(), bits_.size());
+    }
+
+    float dot(const Vector<float>& other) const {
+        check_size(other.size());
+        return packed_dot<Codec>(bits_.data(), other.data(), bits_.size());
+    }
+
+private:
+    Vector<uint16_t> bits_;
+
+    void check_size(size_t n) const {
+        if (n != bits_.size()) {
+            VECTOR_THROW(std::invalid_argument("PackedFloatVector size mismatch"));
+        }
+    }
+};
+
+using HalfVector = PackedFloatVector<HalfCodec>;
+using BFloat16Vector = PackedFloatVector<BFloat16Codec>;
+
+// Values are quantized a block at a time, each block with its own scale and zero point. The last
+// size() % BlockSize values are kept as plain floats until their block fills, so appending never
+// re-quantizes already rounded data; reads, sum() and dot() cover that tail exactly.
+template <typename Code = int8_t, size_t BlockSize = 32>
+class QuantizedVector {
+    static_assert(std::is_integral_v<Code> && sizeof(Code) <= 2, "QuantizedVector codes must be 8- or 16-bit integers");
+    static_assert(BlockSize > 0, "QuantizedVector block size must be non-zero");
+
+public:
+    static constexpr size_t block_size = BlockSize;
+
+    QuantizedVector() = default;
+    explicit QuantizedVector(const Vector<float>& values) { assign(values); }
+
+    size_t size() const { return codes_.size() + pending_.size(); }
+    bool empty() const { return size() == 0; }
+    // Quantized blocks only; the unfinished tail is not counted.
+    size_t block_count() const { return scales_.size(); }
+    void clear() {
+        codes_.clear();
+        scales_.clear();
+        zeros_.clear();
+        pending_.clear();
+    }
+
+    // Codes of the block_count() * BlockSize quantized values.
+    const Code* codes() const noexcept { return codes_.data(); }
+    float scale(size_t block) const { return scales_[block]; }
+    float zero_point(size_t block) const { return zeros_[block]; }
+
+    float operator[](size_t index) const {
+        if (index >= codes_.size()) {
+            return pending_[index - codes_.size()];
+        }
+        size_t b = index / BlockSize;
+        return zeros_[b] + scales_[b] * static_cast<float>(codes_[index]);
+    }
+
+    float at(size_t index) const {
+        if (index >= size()) {
+            VECTOR_THROW(std::out_of_range("QuantizedVector index out of range"));
+        }
+        return (*this)[index];
+    }
+
+    void assign(const Vector<float>& values) {
+        clear();
+        append(values.data(), values.size());
+    }
+
+    void append(const float* values, size_t n) {
+        if (!pending_.empty()) {
+            size_t take = std::min(n, BlockSize - pending_.size());
+            for (size_t i = 0; i < take; ++i) {
+                pending_.push_back(values[i]);
+            }
+            values += take;
+            n -= take;
+            if (pending_.size() < BlockSize) {
+                return;
+            }
+            quantize_blocks(pending_.data(), BlockSize);
+            pending_.clear();
+        }
+        size_t whole = n - n % BlockSize;
+        quantize_blocks(values, whole);
+        if (whole < n) {
+            pending_.reserve(BlockSize);
+            for (size_t i = whole; i < n; ++i) {
+                pending_.push_back(values[i]);
+            }
+        }
+    }
+
+    void push_back(float value) { append(&value, 1); }
+
+    void to_float(Vector<float>& out) const {
+        out.resize(size());
+        for (size_t b = 0; b < scales_.size(); ++b) {
+            size_t start = b * BlockSize;
+            size_t end = std::min(start + BlockSize, codes_.size());
+            float s = scales_[b];
+            float z = zeros_[b];
+            for (size_t i = start; i < end; ++i) {
+                out[i] = z + s * static_cast<float>(codes_[i]);
+            }
+        }
+        std::copy(pending_.begin(), pending_.end(), out.data() + codes_.size());
+    }
+
+    Vector<float> to_vector() const {
+        Vector<float> out;
+        to_float(out);
+        return out;
+    }
+
+    float sum() const {
+        float total = 0.0f;
+        for (size_t b = 0; b < scales_.size(); ++b) {
+            size_t start = b * BlockSize;
+            size_t len = std::min(BlockSize, codes_.size() - start);
+            total += zeros_[b] * static_cast<float>(len) + scales_[b] * static_cast<float>(code_sum(codes_.data() + start, len));
+        }
+        for (size_t i = 0; i < pending_.size(); ++i) {
+            total += pending_[i];
+        }
+        return total;
+    }
+
+    float dot(const QuantizedVector& other) const {
+        if (other.size() != size()) {
+            VECTOR_THROW(std::invalid_argument("QuantizedVector size mismatch"));
+        }
+        float total = 0.0f;
+        for (size_t b = 0; b < scales_.size(); ++b) {
+            size_t start = b * BlockSize;
+            size_t len = std::min(BlockSize, codes_.size() - start);
+            const Code* x = codes_.data() + start;
+            const Code* y = other.codes_.data() + start;
+            float sx = scales_[b], zx = zeros_[b];
+            float sy = other.scales_[b], zy = other.zeros_[b];
+            total += static_cast<float>(len) * zx * zy
+                + zx * sy * static_cast<float>(code_sum(y, len))
+                + zy * sx * static_cast<float>(code_sum(x, len))
+                + sx * sy * static_cast<float>(code_dot(x, y, len));
+        }
+        for (size_t i = 0; i < pending_.size(); ++i) {
+            total += pending_[i] * other.pending_[i];
+        }
+        return total;
+    }
+
+    float dot(const Vector<float>& other) const {
+        if (other.size() != size()) {
+            VECTOR_THROW(std::invalid_argument("QuantizedVector size mismatch"));
+        }
+        float total = 0.0f;
+        for (size_t b = 0; b < scales_.size(); ++b) {
+            size_t start = b * BlockSize;
+            size_t end = std::min(start + BlockSize, codes_.size());
+            float plain = 0.0f;
+            float weighted = 0.0f;
+            for (size_t i = start; i < end; ++i) {
+                plain += other[i];
+                weighted += other[i] * static_cast<float>(codes_[i]);
+            }
+            total += zeros_[b] * plain + scales_[b] * weighted;
+        }
+        for (size_t i = 0; i < pending_.size(); ++i) {
+            total += pending_[i] * other[codes_.size() + i];
+        }
+        return total;
+    }
+
+private:
+    static constexpr float code_min = static_cast<float>(std::numeric_limits<Code>::min());
+    static constexpr float code_max = static_cast<float>(std::numeric_limits<Code>::max());
+
+    Vector<Code> codes_;
+    Vector<float> scales_;
+    Vector<float> zeros_;
+    Vector<float> pending_;
+
+    // n is a multiple of BlockSize. The block range covers its finite values only; infinities
+    // take the code of the nearest end of that range and NaN the code nearest to zero, so every
+    // code, scale and zero point is finite.
+    void quantize_blocks(const float* values, size_t n) {
+        size_t start = codes_.size();
+        codes_.resize(start + n);
+        for (size_t offset = 0; offset < n; offset += BlockSize) {
+            size_t len = std::min(BlockSize, n - offset);
+            const float* block = values + offset;
+            float lo = std::numeric_limits<float>::infinity();
+            float hi = -lo;
+            for (size_t i = 0; i < len; ++i) {
+                if (std::isfinite(block[i])) {
+                    lo = std::min(lo, block[i]);
+                    hi = std::max(hi, block[i]);
+                }
+            }
+            if (lo > hi) {
+                lo = hi = 0.0f;
+            }
+            // In double: hi - lo and code_min * s can overflow float for ranges wider than FLT_MAX.
+            float s = static_cast<float>((static_cast<double>(hi) - lo) / (code_max - code_min));
+            float z = static_cast<float>(lo - static_cast<double>(code_min) * s);
+            // A subnormal scale would make the reciprocal infinite.
+            float inv = (s >= std::numeric_limits<float>::min()) ? 1.0f / s : 0.0f;
+            Code* out = codes_.data() + start + offset;
+            for (size_t i = 0; i < len; ++i) {
+                float v = std::isnan(block[i]) ? 0.0f : std::min(std::max(block[i], lo), hi);
+                float q = std::nearbyint((v - z) * inv);
+                out[i] = static_cast<Code>(std::min(std::max(q, code_min), code_max));
+            }
+            scales_.push_back(s);
+            zeros_.push_back(z);
+        }
+    }
+
+    static int32_t code_sum_scalar(const Code* x, size_t n) {
+        int32_t total = 0;
+        for (size_t i = 0; i < n; ++i) {
+            total += x[i];
+        }
+        return total;
+    }
+
+    static int64_t code_dot_scalar(const Code* x, const Code* y, size_t n) {
+        int64_t total = 0;
+        for (size_t i = 0; i < n; ++i) {
+            total += static_cast<int64_t>(x[i]) * y[i];
+        }
+        return total;
+    }
+
+#if VECTOR_DISPATCH_X86
+    // int8 codes widen to int16 and pairs are summed by madd into int32 lanes. Each lane takes at
+    // most BlockSize / lanes products of |x*y| <= 2^14, far below overflow for any sane block.
+    VECTOR_TARGET_SSE42 static int32_t code_sum_sse42(const Code* x, size_t n) {
+        size_t i = 0;
+        __m128i acc = _mm_setzero_si128();
+        for (; i + 8 <= n; i += 8) {
+            __m128i wide = _mm_cvtepi8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(x + i)));
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(wide, _mm_set1_epi16(1)));
+        }
+        return detail::hsum(acc) + code_sum_scalar(x + i, n - i);
+    }
+
+    VECTOR_TARGET_SSE42 static int64_t code_dot_sse42(const Code* x, const Code* y, size_t n) {
+        size_t i = 0;
+        __m128i acc = _mm_setzero_si128();
+        for (; i + 8 <= n; i += 8) {
+            __m128i wx = _mm_cvtepi8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(x + i)));
+            __m128i wy = _mm_cvtepi8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + i)));
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(wx, wy));
+        }
+        return detail::hsum(acc) + code_dot_scalar(x + i, y + i, n - i);
+    }
+
+    VECTOR_TARGET_AVX2 static int32_t code_sum_avx2(const Code* x, size_t n) {
+        size_t i = 0;
+        __m256i acc = _mm256_setzero_si256();
+        __m256i ones = _mm256_set1_epi16(1);
+        for (; i + 16 <= n; i += 16) {
+            __m256i wide = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)));
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(wide, ones));
+        }
+        return detail::hsum(acc) + code_sum_scalar(x + i, n - i);
+    }
+
+    VECTOR_TARGET_AVX2 static int64_t code_dot_avx2(const Code* x, const Code* y, size_t n) {
+        size_t i = 0;
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 16 <= n; i += 16) {
+            __m256i wx = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)));
+            __m256i wy = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i)));
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(wx, wy));
+        }
+        return detail::hsum(acc) + code_dot_scalar(x + i, y + i, n - i);
+    }
+
+    VECTOR_TARGET_AVX512 static int64_t code_dot_avx512(const Code* x, const Code* y, size_t n) {
+        size_t i = 0;
+        __m512i acc = _mm512_setzero_si512();
+        for (; i + 32 <= n; i += 32) {
+            __m512i wx = _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i)));
+            __m512i wy = _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i)));
+            acc = _mm512_add_epi32(acc, _mm512_madd_epi16(wx, wy));
+        }
+        return _mm512_reduce_add_epi32(acc) + code_dot_avx2(x + i, y + i, n - i);
+    }
+#endif
+
+    static int32_t code_sum(const Code* x, size_t n) {
+#if VECTOR_DISPATCH_X86
+        if constexpr (std::is_same_v<Code, int8_t>) {
+            static const auto kernel = select_kernel(&code_sum_scalar, &code_sum_sse42, &code_sum_avx2, nullptr);
+            return kernel(x, n);
+        }
+#endif
+        return code_sum_scalar(x, n);
+    }
+
+    static int64_t code_dot(const Code* x, const Code* y, size_t n) {
+#if VECTOR_DISPATCH_X86
+        if constexpr (std::is_same_v<Code, int8_t>) {
+            static const auto kernel = select_kernel(&code_dot_scalar, &code_dot_sse42, &code_dot_avx2, &code_dot_avx512);
+            return kernel(x, y, n);
+        }
+#endif
+        return code_dot_scalar(x, y, n);
+    }
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "cpuDispatch.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define VECTOR_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#include <cstdint>
+
+namespace detail {
+
+#if VECTOR_DISPATCH_X86
+VECTOR_TARGET_AVX2 inline float hsum(__m256 v) {
+    __m128 lo = _mm256_castps256_ps128(v);
+    __m128 hi = _mm256_extractf128_ps(v, 1);
+    lo = _mm_add_ps(lo, hi);
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    lo = _mm_add_ss(lo, _mm_movehdup_ps(lo));
+    return _mm_cvtss_f32(lo);
+}
+
+VECTOR_TARGET_AVX2 inline int32_t hsum(__m256i v) {
+    __m128i lo = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    lo = _mm_add_epi32(lo, _mm_shuffle_epi32(lo, 0x4E));
+    lo = _mm_add_epi32(lo, _mm_shuffle_epi32(lo, 0xB1));
+    return _mm_cvtsi128_si32(lo);
+}
+
+VECTOR_TARGET_SSE42 inline int32_t hsum(__m128i v) {
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, 0x4E));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, 0xB1));
+    return _mm_cvtsi128_si32(v);
+}
+#endif
+
+} // namespace detail
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "customVector.hpp"
+#include "vectorHash.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+// Interns strings to dense uint32_t ids. Each distinct string is stored once, back to back in a
+// Vector<char> arena with uint32 offsets (size() + 1 of them, as in StringVector), so id -> text
+// is two loads. Text -> id goes through an open-addressing table of 64-bit slots holding the
+// upper half of the string's hash next to id + 1; probes compare the hash half before touching
+// the arena. The table stays at most half full.
+//
+// After freeze() the pool is read-only: intern() of a new string throws, and any number of
+// threads may call find() and view() concurrently.
+class StringPool {
+public:
+    static constexpr uint32_t kNotFound = UINT32_MAX;
+
+    StringPool() { offsets_.push_back(0); }
+
+    size_t size() const noexcept { return offsets_.size() - 1; }
+    bool empty() const noexcept { return size() == 0; }
+    size_t arena_bytes() const noexcept { return arena_.size(); }
+    bool frozen() const noexcept { return frozen_; }
+
+    void reserve(size_t strings, size_t total_chars) {
+        offsets_.reserve(strings + 1);
+        arena_.reserve(total_chars);
+        size_t need = table_capacity_for(strings);
+        if (need > slots_.size()) {
+            rehash(need);
+        }
+    }
+
+    // The id of s, adding it if it is new. Ids are assigned 0, 1, 2, ... in first-seen order.
+    uint32_t intern(std::string_view s) { return intern_hashed(s, hash_bytes(s.data(), s.size())); }
+
+    // Interns n strings into ids[0..n). Hashes are computed and their home slots prefetched a
+    // window ahead, so probing overlaps the table's cache misses.
+    void intern_batch(const std::string_view* strings, size_t n, uint32_t* ids) {
+        constexpr size_t kWindow = 16;
+        uint64_t hashes[kWindow];
+        for (size_t base = 0; base < n; base += kWindow) {
+            size_t count = std::min(kWindow, n - base);
+            for (size_t j = 0; j < count; ++j) {
+                hashes[j] = hash_bytes(strings[base + j].data(), strings[base + j].size());
+                prefetch_home(hashes[j]);
+            }
+            for (size_t j = 0; j < count; ++j) {
+                ids[base + j] = intern_hashed(strings[base + j], hashes[j]);
+            }
+        }
+    }
+
+    template <typename Allocator>
+    Vector<uint32_t> intern_batch(const Vector<std::string_view, Allocator>& strings) {
+        Vector<uint32_t> ids;
+        ids.resize_for_overwrite(strings.size());
+        intern_batch(strings.data(), strings.size(), ids.data());
+        return ids;
+    }
+
+    // The id of s, or kNotFound; never modifies the pool.
+    uint32_t find(std::string_view s) const {
+        if (slots_.empty()) {
+            return kNotFound;
+        }
+        uint64_t slot = slots_[probe(s, hash_bytes(s.data(), s.size()))];
+        return slot == 0 ? kNotFound : static_cast<uint32_t>(slot) - 1;
+    }
+
+    bool contains(std::string_view s) const { return find(s) != kNotFound; }
+
+    // Unchecked id -> text; the view stays valid until the next intern() that adds a string.
+    std::string_view view(uint32_t id) const {
+        return std::string_view(arena_.data() + offsets_[id], offsets_[id + 1] - offsets_[id]);
+    }
+
+    std::string_view operator[](uint32_t id) const { return view(id); }
+
+    std::string_view at(uint32_t id) const {
+        if (id >= size()) {
+            VECTOR_THROW(std::out_of_range("StringPool id out of range"));
+        }
+        return view(id);
+    }
+
+    const Vector<char>& arena() const noexcept { return arena_; }
+    const Vector<uint32_t>& offsets() const noexcept { return offsets_; }
+
+    // Makes the pool read-only and releases the arena's spare capacity. Views taken after
+    // freezing stay valid for the pool's lifetime.
+    void freeze() {
+        arena_.shrink_to_fit();
+        offsets_.shrink_to_fit();
+        frozen_ = true;
+    }
+
+    void clear() {
+        if (frozen_) {
+            VECTOR_THROW(std::logic_error("StringPool is frozen"));
+        }
+        arena_.clear();
+        offsets_.clear();
+        offsets_.push_back(0);
+        std::fill(slots_.data(), slots_.data() + slots_.size(), uint64_t(0));
+    }
+
+private:
+    Vector<char> arena_;
+    Vector<uint32_t> offsets_;
+    Vector<uint64_t> slots_;
+    bool frozen_ = false;
+
+    static size_t table_capacity_for(size_t strings) {
+        size_t capacity = 16;
+        while (capacity < strings * 2) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    void prefetch_home(uint64_t h) const {
+#if defined(__GNUC__)
+        if (!slots_.empty()) {
+            __builtin_prefetch(slots_.data() + (static_cast<uint32_t>(h >> 32) & (slots_.size() - 1)));
+        }
+#else
+        (void)h;
+#endif
+    }
+
+    // Index of the slot holding s, or of the empty slot where it would go.
+    size_t probe(std::string_view s, uint64_t h) const {
+        size_t mask = slots_.size() - 1;
+        uint32_t tag = static_cast<uint32_t>(h >> 32);
+        for (size_t i = tag & mask;; i = (i + 1) & mask) {
+            uint64_t slot = slots_[i];
+            if (slot == 0 || (static_cast<uint32_t>(slot >> 32) == tag && view(static_cast<uint32_t>(slot) - 1) == s)) {
+                return i;
+            }
+        }
+    }
+
+    uint32_t intern_hashed(std::string_view s, uint64_t h) {
+        if (!frozen_ && (size() + 1) * 2 > slots_.size()) {
+            rehash(table_capacity_for(size() + 1));
+        }
+        size_t i = slots_.empty() ? 0 : probe(s, h);
+        if (!slots_.empty() && slots_[i] != 0) {
+            return static_cast<uint32_t>(slots_[i]) - 1;
+        }
+        if (frozen_) {
+            VECTOR_THROW(std::logic_error("StringPool is frozen"));
+        }
+        size_t start = arena_.size();
+        if (start + s.size() > UINT32_MAX || size() + 1 >= kNotFound) {
+            VECTOR_THROW(std::length_error("StringPool exceeds 32-bit offsets"));
+        }
+        uint32_t id = static_cast<uint32_t>(size());
+        // Offsets first: if growing the arena then fails, popping the offset undoes everything.
+        offsets_.push_back(static_cast<uint32_t>(start + s.size()));
+        VECTOR_TRY {
+            arena_.resize_for_overwrite(start + s.size());
+        }
+        VECTOR_CATCH_ALL {
+            offsets_.pop_back();
+            VECTOR_RETHROW;
+        }
+        if (!s.empty()) {
+            std::memcpy(arena_.data() + start, s.data(), s.size());
+        }
+        slots_[i] = (static_cast<uint64_t>(h >> 32) << 32) | (static_cast<uint64_t>(id) + 1);
+        return id;
+    }
+
+    // Fills the new table before swapping it in, so a failed allocation leaves the index intact.
+    void rehash(size_t capacity) {
+        Vector<uint64_t> table(capacity, 0);
+        size_t mask = capacity - 1;
+        for (size_t j = 0; j < slots_.size(); ++j) {
+            uint64_t slot = slots_[j];
+            if (slot == 0) {
+                continue;
+            }
+            size_t i = static_cast<uint32_t>(slot >> 32) & mask;
+            while (table[i] != 0) {
+                i = (i + 1) & mask;
+            }
+            table[i] = slot;
+        }
+        slots_ = std::move(table);
+    }
+};
@@ -0,0 +1,130 @@
+#include "../anyVector.hpp"
+#include "check.hpp"
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// Builds a column of every element type from the same small integers and checks a kernel gives
+// the same answer for each.
+template <typename F>
+bool same_for_every_type(const int* values, size_t n, F&& check) {
+    bool ok = true;
+    for (int t = 0; t <= static_cast<int>(ElementType::Float64); ++t) {
+        ElementType type = static_cast<ElementType>(t);
+        AnyVector column(type);
+        dispatch_element_type(type, [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            for (size_t i = 0; i < n; ++i) {
+                column.push_back(static_cast<T>(values[i]));
+            }
+        });
+        ok = ok && column.type() == type && column.size() == n && check(column);
+    }
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    CHECK(element_size(ElementType::Int8) == 1 && element_size(ElementType::UInt16) == 2);
+    CHECK(element_size(ElementType::Float32) == 4 && element_size(ElementType::Float64) == 8);
+    CHECK(std::string(element_type_name(ElementType::UInt64)) == "uint64");
+
+    // Typed access checks both the type and the index.
+    {
+        AnyVector column(ElementType::Int32, 3);
+        CHECK(column.size() == 3 && column.size_bytes() == 12 && column.get<int32_t>(2) == 0);
+        CHECK(reinterpret_cast<uintptr_t>(column.data()) % 64 == 0);
+        column.set<int32_t>(1, -7);
+        CHECK(column.get<int32_t>(1) == -7 && column.holds<int32_t>() && !column.holds<uint32_t>());
+        CHECK_THROWS(column.get<int64_t>(0), std::invalid_argument);
+        CHECK_THROWS(column.set<float>(0, 1.0f), std::invalid_argument);
+        CHECK_THROWS(column.push_back<int16_t>(1), std::invalid_argument);
+        CHECK_THROWS(column.get<int32_t>(3), std::out_of_range);
+        CHECK_THROWS(column.to_vector<double>(), std::invalid_argument);
+        CHECK(column.size() == 3);
+
+        AnyVector other(ElementType::UInt32, 1);
+        CHECK_THROWS(column.append(other), std::invalid_argument);
+        AnyVector more = AnyVector::from(Vector<int32_t>(2, 5));
+        column.append(more);
+        column.append(AnyVector(ElementType::Int32));
+        Vector<int32_t> back = column.to_vector<int32_t>();
+        CHECK(back.size() == 5 && back[1] == -7 && back[4] == 5);
+        CHECK(AnyVector::from(back) == column);
+        column.clear();
+        CHECK(column.empty() && column != AnyVector::from(back));
+        CHECK(AnyVector(ElementType::Int32) == column && AnyVector(ElementType::Int64) != column);
+    }
+
+    // Kernels agree across every element type.
+    const int values[] = {5, 3, 9, 3, 0, 7, 1, 9};
+    const size_t n = sizeof(values) / sizeof(values[0]);
+    CHECK(same_for_every_type(values, n, [](const AnyVector& c) { return sum(c) == 37.0 && sum<int64_t>(c) == 37; }));
+    CHECK(same_for_every_type(values, n, [](const AnyVector& c) {
+        Vector<uint32_t> order = argsort(c);
+        // Stable: the two 3s and the two 9s keep their input order.
+        const uint32_t expected[] = {4, 6, 1, 3, 0, 5, 2, 7};
+        bool ok = order.size() == n;
+        for (size_t i = 0; ok && i < n; ++i) {
+            ok = order[i] == expected[i];
+        }
+        AnyVector sorted = c;
+        sort(sorted);
+        return ok && take(c, order) == sorted;
+    }));
+    CHECK(same_for_every_type(values, n, [](const AnyVector& c) {
+        Vector<uint8_t> mask(n, 0);
+        mask[2] = mask[5] = mask[7] = 1;
+        AnyVector picked = filter(c, mask);
+        AnyVector big = filter_if(c, [](auto v) { return v > 6; });
+        return picked.size() == 3 && sum(picked) == 25.0 && big == picked && filter(c, Vector<uint8_t>(n, 0)).empty();
+    }));
+    CHECK(same_for_every_type(values, n, [](const AnyVector& c) {
+        return dispatch_element_type(c.type(), [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            return hash(c, 3) == hash(c.to_vector<T>(), 3);
+        });
+    }));
+
+    // Empty columns pass through every kernel.
+    {
+        AnyVector empty(ElementType::Float32);
+        CHECK(sum(empty) == 0.0 && argsort(empty).empty() && filter_if(empty, [](auto) { return true; }).empty());
+        CHECK(take(empty, Vector<uint32_t>()).empty() && row_hashes(empty).empty());
+        sort(empty);
+    }
+
+    // Floats: NaN sorts last, and -0.0 and 0.0 share a row hash.
+    {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        Vector<double> raw;
+        raw.push_back(nan);
+        raw.push_back(2.0);
+        raw.push_back(-0.0);
+        raw.push_back(nan);
+        raw.push_back(-1.0);
+        raw.push_back(0.0);
+        AnyVector column = AnyVector::from(raw);
+        Vector<uint32_t> order = argsort(column);
+        CHECK(order[0] == 4 && order[3] == 1 && order[4] == 0 && order[5] == 3);
+        sort(column);
+        CHECK(column.get<double>(0) == -1.0 && column.get<double>(3) == 2.0 && std::isnan(column.get<double>(5)));
+        Vector<uint64_t> hashes = row_hashes(AnyVector::from(raw));
+        CHECK(hashes[2] == hashes[5] && hashes[1] != hashes[4]);
+        CHECK(row_hashes(AnyVector::from(raw), 1)[1] != hashes[1]);
+    }
+
+    // Errors: mismatched mask lengths and out-of-range gathers.
+    {
+        AnyVector column(ElementType::UInt8, 4);
+        CHECK_THROWS(filter(column, Vector<uint8_t>(3, 1)), std::invalid_argument);
+        Vector<uint32_t> indices(2, 1);
+        indices[1] = 4;
+        CHECK_THROWS(take(column, indices), std::out_of_range);
+    }
+
+    return test::result();
+}
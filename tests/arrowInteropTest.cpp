@@ -0,0 +1,140 @@
+#include "../arrowInterop.hpp"
+#include "check.hpp"
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+int foreign_releases = 0;
+
+void release_foreign(ArrowArray* array) {
+    ++foreign_releases;
+    array->release = nullptr;
+}
+
+// An array as another producer might hand it over: a validity bitmap and a non-zero offset.
+ArrowArray foreign_array(const void** buffers, int64_t length, int64_t offset, int64_t null_count) {
+    ArrowArray array;
+    array.length = length;
+    array.null_count = null_count;
+    array.offset = offset;
+    array.n_buffers = 2;
+    array.n_children = 0;
+    array.buffers = buffers;
+    array.children = nullptr;
+    array.dictionary = nullptr;
+    array.release = &release_foreign;
+    array.private_data = nullptr;
+    return array;
+}
+
+} // namespace
+
+int main() {
+    // Export hands over the buffer itself; the column reads it in place and releases it once.
+    {
+        ArrowVector<int32_t> values;
+        for (int32_t i = 0; i < 1000; ++i) {
+            values.push_back(i * 3);
+        }
+        const int32_t* buffer = values.data();
+        CHECK(reinterpret_cast<uintptr_t>(buffer) % 64 == 0);
+        ArrowArray array;
+        ArrowSchema schema;
+        export_to_arrow(std::move(values), &array, &schema);
+        CHECK(values.empty());
+        CHECK(array.length == 1000 && array.null_count == 0 && array.offset == 0);
+        CHECK(array.n_buffers == 2 && array.buffers[0] == nullptr && array.buffers[1] == buffer);
+        CHECK(std::strcmp(schema.format, "i") == 0 && schema.release != nullptr);
+
+        ArrowColumn<int32_t> column(&array, &schema);
+        CHECK(array.release == nullptr);
+        CHECK(column.size() == 1000 && column.data() == buffer && column[999] == 2997);
+        CHECK(column.is_valid(10));
+        ArrowColumn<int32_t> moved(std::move(column));
+        Vector<int32_t> copy = moved.to_vector();
+        CHECK(copy.size() == 1000 && copy[500] == 1500);
+        schema.release(&schema);
+        CHECK(schema.release == nullptr);
+    }
+
+    // Empty Vectors and a plain (unaligned) allocator export too; a null schema is allowed.
+    {
+        Vector<double> empty;
+        ArrowArray array;
+        export_to_arrow(std::move(empty), &array, nullptr);
+        CHECK(array.length == 0);
+        ArrowColumn<double> column(&array, nullptr);
+        CHECK(column.empty() && column.begin() == column.end());
+    }
+
+    // Strings use the three-buffer layout, including empty strings and an empty vector.
+    {
+        StringVector strings;
+        CHECK(strings.empty());
+        strings.push_back("alpha");
+        strings.push_back("");
+        strings.push_back("gamma");
+        CHECK(strings.size() == 3 && strings[1].empty() && strings[2] == "gamma");
+        CHECK(strings.offsets().size() == 4 && strings.offsets()[3] == 10);
+        ArrowArray array;
+        ArrowSchema schema;
+        export_to_arrow(std::move(strings), &array, &schema);
+        CHECK(std::strcmp(schema.format, "u") == 0 && array.n_buffers == 3 && array.length == 3);
+        ArrowStringColumn column(&array, &schema);
+        CHECK(column.size() == 3 && column[0] == "alpha" && column[1] == "" && column[2] == "gamma");
+
+        // The moved-from vector is usable again.
+        CHECK(strings.size() == 0);
+        strings.push_back("again");
+        CHECK(strings.size() == 1 && strings[0] == "again");
+
+        StringVector none;
+        ArrowArray empty_array;
+        export_to_arrow(std::move(none), &empty_array, nullptr);
+        ArrowStringColumn empty_column(&empty_array, nullptr);
+        CHECK(empty_column.empty());
+    }
+
+    // Foreign arrays: offset and validity bits are honoured; release runs on destruction.
+    {
+        int16_t data[6] = {10, 11, 12, 13, 14, 15};
+        uint8_t validity[1] = {0x3B}; // 0b111011: element 2 is null
+        const void* buffers[2] = {validity, data};
+        ArrowArray array = foreign_array(buffers, 4, 1, 1);
+        {
+            ArrowColumn<int16_t> column(&array, nullptr);
+            CHECK(column.size() == 4 && column.null_count() == 1);
+            CHECK(column[0] == 11 && column[3] == 14);
+            CHECK(column.is_valid(0) && !column.is_valid(1) && column.is_valid(2));
+            CHECK(foreign_releases == 0);
+        }
+        CHECK(foreign_releases == 1);
+    }
+
+    // Import errors: released arrays, mismatched formats and unexpected layouts. A rejected
+    // array is left with the caller, still unreleased.
+    {
+        int64_t data[2] = {1, 2};
+        const void* buffers[2] = {nullptr, data};
+        ArrowSchema schema;
+        detail::fill_arrow_schema(&schema, "l");
+
+        ArrowArray released = foreign_array(buffers, 2, 0, 0);
+        released.release = nullptr;
+        CHECK_THROWS(ArrowColumn<int64_t>(&released, &schema), std::invalid_argument);
+
+        ArrowArray array = foreign_array(buffers, 2, 0, 0);
+        CHECK_THROWS(ArrowColumn<double>(&array, &schema), std::invalid_argument);
+        CHECK_THROWS(ArrowStringColumn(&array, nullptr), std::invalid_argument);
+        array.n_children = 1;
+        CHECK_THROWS(ArrowColumn<int64_t>(&array, &schema), std::invalid_argument);
+        array.n_children = 0;
+        CHECK(array.release != nullptr);
+        ArrowColumn<int64_t> column(&array, &schema);
+        CHECK(column[1] == 2);
+    }
+    CHECK(foreign_releases == 2);
+
+    return test::result();
+}
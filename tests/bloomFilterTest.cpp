@@ -0,0 +1,124 @@
+#include "../bloomFilter.hpp"
+#include "check.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+Vector<uint64_t> keys(uint64_t first, size_t n) {
+    Vector<uint64_t> out;
+    for (size_t i = 0; i < n; ++i) {
+        out.push_back(first + i * 0x9E3779B97F4A7C15ull);
+    }
+    return out;
+}
+
+} // namespace
+
+int main() {
+    const size_t n = 20000;
+    Vector<uint64_t> members = keys(1, n);
+    Vector<uint64_t> others = keys(2, n);
+
+    // No false negatives, a false positive rate near the 10 bits/key design point, and batch
+    // results identical to single-key calls (lengths that are not a multiple of the window).
+    BlockedBloomFilter blocked(n);
+    blocked.insert_batch(members.data(), n - 3);
+    blocked.insert(members[n - 3]);
+    blocked.insert(members[n - 2]);
+    blocked.insert(members[n - 1]);
+    Vector<uint8_t> hits = blocked.contains_batch(members);
+    size_t found = 0;
+    for (size_t i = 0; i < n; ++i) {
+        found += hits[i];
+    }
+    CHECK(found == n);
+    Vector<uint8_t> false_hits(n);
+    size_t false_positives = blocked.contains_batch(others.data(), n, false_hits.data());
+    CHECK(false_positives < n / 50);
+    bool batch_matches = true;
+    for (size_t i = 0; i < n; ++i) {
+        batch_matches = batch_matches && (false_hits[i] != 0) == blocked.contains(others[i]);
+    }
+    CHECK(batch_matches);
+    CHECK(blocked.contains(std::string("absent")) == blocked.contains_hash(detail::bloom_key_hash(std::hash<std::string>{}("absent"))));
+    blocked.insert(std::string("present"));
+    CHECK(blocked.contains(std::string("present")));
+
+    // Serialization round trip and rejection of malformed input.
+    Vector<uint8_t> bytes = blocked.serialize();
+    BlockedBloomFilter restored = BlockedBloomFilter::deserialize(bytes.data(), bytes.size());
+    CHECK(restored.block_count() == blocked.block_count() && restored.contains(members[0]));
+    CHECK_THROWS(BlockedBloomFilter::deserialize(bytes.data(), bytes.size() - 1), std::invalid_argument);
+    CHECK_THROWS(BlockedBloomFilter::deserialize(bytes.data(), 11), std::invalid_argument);
+    CHECK_THROWS(CountingBloomFilter::deserialize(bytes.data(), bytes.size()), std::invalid_argument);
+
+    // Merge is a union and needs equal sizes.
+    BlockedBloomFilter other(n);
+    other.insert(others[0]);
+    other.merge(blocked);
+    CHECK(other.contains(others[0]) && other.contains(members[5]));
+    CHECK_THROWS(other.merge(BlockedBloomFilter(10 * n)), std::invalid_argument);
+    other.clear();
+    CHECK(!other.contains(others[0]));
+
+    // Counting filter: batch paths, erase and saturation.
+    CountingBloomFilter counting(n);
+    counting.insert_batch(members.data(), n);
+    Vector<uint8_t> counted(n);
+    CHECK(counting.contains_batch(members.data(), n, counted.data()) == n);
+    size_t counting_false = counting.contains_batch(others.data(), n, counted.data());
+    bool counting_matches = true;
+    for (size_t i = 0; i < n; ++i) {
+        counting_matches = counting_matches && (counted[i] != 0) == counting.contains(others[i]);
+    }
+    CHECK(counting_matches && counting_false < n / 50);
+    for (size_t i = 0; i < n / 2; ++i) {
+        counting.erase(members[i]);
+    }
+    size_t remaining = 0;
+    for (size_t i = n / 2; i < n; ++i) {
+        remaining += counting.contains(members[i]);
+    }
+    CHECK(remaining == n - n / 2);
+    size_t erased_still_present = 0;
+    for (size_t i = 0; i < n / 2; ++i) {
+        erased_still_present += counting.contains(members[i]);
+    }
+    CHECK(erased_still_present < n / 20);
+
+    // A saturated counter stays set through any number of erases.
+    CountingBloomFilter saturated(16);
+    for (int i = 0; i < 20; ++i) {
+        saturated.insert(42);
+    }
+    for (int i = 0; i < 40; ++i) {
+        saturated.erase(42);
+    }
+    CHECK(saturated.contains(42));
+
+    // Counter merge saturates, and the bit filter view keeps every member.
+    CountingBloomFilter a(16);
+    CountingBloomFilter b(16);
+    for (int i = 0; i < 10; ++i) {
+        a.insert(7);
+        b.insert(7);
+    }
+    a.merge(b);
+    for (int i = 0; i < 14; ++i) {
+        a.erase(7);
+    }
+    CHECK(a.contains(7));
+    BlockedBloomFilter bits = counting.to_bloom_filter();
+    size_t bit_hits = 0;
+    for (size_t i = n / 2; i < n; ++i) {
+        bit_hits += bits.contains(members[i]);
+    }
+    CHECK(bit_hits == n - n / 2);
+    Vector<uint8_t> counting_bytes = counting.serialize();
+    CountingBloomFilter counting_restored = CountingBloomFilter::deserialize(counting_bytes.data(), counting_bytes.size());
+    CHECK(counting_restored.contains(members[n - 1]));
+    CHECK_THROWS(a.merge(counting), std::invalid_argument);
+
+    return test::result();
+}
@@ -0,0 +1,178 @@
+#include "../byteBuffer.hpp"
+#include "check.hpp"
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+int main() {
+    // Zigzag keeps small magnitudes small and round-trips the extremes.
+    CHECK(zigzag_encode(0) == 0 && zigzag_encode(-1) == 1 && zigzag_encode(1) == 2 && zigzag_encode(-2) == 3);
+    CHECK(zigzag_encode(std::numeric_limits<int64_t>::max()) == std::numeric_limits<uint64_t>::max() - 1);
+    CHECK(zigzag_encode(std::numeric_limits<int64_t>::min()) == std::numeric_limits<uint64_t>::max());
+    CHECK(zigzag_decode(zigzag_encode(std::numeric_limits<int64_t>::min())) == std::numeric_limits<int64_t>::min());
+
+    // Fixed-width values are little-endian regardless of host order; varints are LEB128 and
+    // take exactly as many bytes as needed, up to ten.
+    {
+        ByteBuffer buffer;
+        buffer.put_u32(0x01020304u);
+        CHECK(buffer.size() == 4 && buffer.data()[0] == 0x04 && buffer.data()[3] == 0x01);
+        buffer.clear();
+        buffer.put_varint(300);
+        CHECK(buffer.size() == 2 && buffer.data()[0] == 0xAC && buffer.data()[1] == 0x02);
+        buffer.clear();
+        buffer.put_varint(0);
+        buffer.put_varint(127);
+        buffer.put_varint(128);
+        CHECK(buffer.size() == 4);
+        buffer.clear();
+        buffer.put_varint(std::numeric_limits<uint64_t>::max());
+        CHECK(buffer.size() == kMaxVarintBytes && buffer.data()[9] == 0x01);
+    }
+
+    // Round trip of every field kind; the writer's unused reservation is not kept.
+    {
+        ByteBuffer buffer(4);
+        buffer.put_u8(0xFE);
+        buffer.put_u16(0xBEEF);
+        buffer.put_u64(0x0123456789ABCDEFull);
+        buffer.put_f32(-1.25f);
+        buffer.put_f64(6.02214076e23);
+        buffer.put_le<int16_t>(-2);
+        buffer.put_svarint(-123456789);
+        buffer.append_bytes("xyz", 3);
+        buffer.append_bytes(nullptr, 0);
+        CHECK(buffer.size() == 1 + 2 + 8 + 4 + 8 + 2 + 4 + 3);
+
+        ByteReader reader(buffer);
+        CHECK(reader.read_u8() == 0xFE);
+        CHECK(reader.read_u16() == 0xBEEF);
+        CHECK(reader.read_u64() == 0x0123456789ABCDEFull);
+        CHECK(reader.read_f32() == -1.25f);
+        CHECK(reader.read_f64() == 6.02214076e23);
+        CHECK(reader.read_le<int16_t>() == -2);
+        CHECK(reader.read_svarint() == -123456789);
+        char tail[3];
+        reader.read_bytes(tail, 3);
+        CHECK(tail[0] == 'x' && tail[2] == 'z' && reader.at_end());
+
+        Vector<uint8_t> taken = buffer.take();
+        CHECK(taken.size() == 32 && buffer.empty());
+        ByteReader from_vector(taken);
+        from_vector.skip(31);
+        CHECK(from_vector.read_u8() == 'z');
+    }
+
+    // Batch decoding matches one-at-a-time decoding for mixed varint lengths, including runs of
+    // one-byte values that take the sixteen-at-a-time path and values straddling block edges.
+    {
+        std::mt19937_64 rng(42);
+        Vector<uint64_t> values;
+        for (size_t i = 0; i < 5000; ++i) {
+            unsigned bits = (i / 40) % 3 == 0 ? 7 : static_cast<unsigned>(rng() % 65);
+            uint64_t v = bits == 64 ? rng() : rng() & ((uint64_t(1) << bits) - 1);
+            values.push_back(v);
+        }
+        ByteBuffer buffer;
+        buffer.put_varints(values.data(), values.size());
+
+        Vector<uint64_t> batch(values.size());
+        ByteReader reader(buffer);
+        reader.read_varints(batch.data(), 1234);
+        reader.read_varints(batch.data() + 1234, values.size() - 1234);
+        CHECK(reader.at_end());
+        bool same = true;
+        ByteReader single(buffer);
+        for (size_t i = 0; i < values.size(); ++i) {
+            same = same && batch[i] == values[i] && single.read_varint() == values[i];
+        }
+        CHECK(same);
+
+        UncheckedByteReader unchecked(buffer);
+        Vector<uint64_t> again(values.size());
+        unchecked.read_varints(again.data(), again.size());
+        bool unchecked_same = unchecked.at_end();
+        for (size_t i = 0; i < values.size(); ++i) {
+            unchecked_same = unchecked_same && again[i] == values[i];
+        }
+        CHECK(unchecked_same);
+
+        Vector<int64_t> signed_values;
+        for (size_t i = 0; i < 100; ++i) {
+            signed_values.push_back(static_cast<int64_t>(rng()) >> (i % 64));
+        }
+        ByteBuffer signed_buffer;
+        signed_buffer.put_svarints(signed_values.data(), signed_values.size());
+        Vector<int64_t> decoded(signed_values.size());
+        ByteReader signed_reader(signed_buffer);
+        signed_reader.read_svarints(decoded.data(), decoded.size());
+        bool signed_same = signed_reader.at_end();
+        for (size_t i = 0; i < decoded.size(); ++i) {
+            signed_same = signed_same && decoded[i] == signed_values[i];
+        }
+        CHECK(signed_same);
+
+        // Reading fewer values than encoded leaves the reader on the next one.
+        ByteReader partial(buffer);
+        uint64_t first[3];
+        partial.read_varints(first, 3);
+        CHECK(first[2] == values[2] && partial.read_varint() == values[3]);
+    }
+
+    // Truncated input: fixed-width reads, a varint cut mid-way and a batch asking for more
+    // values than are present all throw out_of_range.
+    {
+        ByteBuffer buffer;
+        buffer.put_u16(7);
+        ByteReader reader(buffer);
+        CHECK_THROWS(reader.read_u32(), std::out_of_range);
+        char sink[4];
+        CHECK_THROWS(reader.read_bytes(sink, 3), std::out_of_range);
+        CHECK_THROWS(reader.skip(3), std::out_of_range);
+        CHECK(reader.read_u16() == 7);
+        CHECK_THROWS(reader.read_u8(), std::out_of_range);
+
+        uint8_t cut[2] = {0x80, 0x80};
+        ByteReader cut_reader(cut, 2);
+        CHECK_THROWS(cut_reader.read_varint(), std::out_of_range);
+
+        Vector<uint64_t> few(20, 300);
+        ByteBuffer short_buffer;
+        short_buffer.put_varints(few.data(), few.size());
+        Vector<uint64_t> out(21);
+        ByteReader batch_reader(short_buffer);
+        CHECK_THROWS(batch_reader.read_varints(out.data(), 21), std::out_of_range);
+        ByteReader empty(nullptr, 0);
+        uint64_t none;
+        empty.read_varints(&none, 0);
+        CHECK_THROWS(empty.read_varints(&none, 1), std::out_of_range);
+    }
+
+    // Varints longer than ten bytes are malformed, both in single reads and in batches short
+    // enough for the scalar tail or long enough for the block decoder.
+    {
+        Vector<uint8_t> overlong(11, 0x80);
+        overlong.push_back(0x00);
+        ByteReader single(overlong);
+        CHECK_THROWS(single.read_varint(), std::invalid_argument);
+        uint64_t out[8];
+        ByteReader short_batch(overlong);
+        CHECK_THROWS(short_batch.read_varints(out, 1), std::invalid_argument);
+
+        Vector<uint8_t> long_input;
+        for (int i = 0; i < 13; ++i) {
+            long_input.push_back(0x05);
+        }
+        for (int i = 0; i < 11; ++i) {
+            long_input.push_back(0x80);
+        }
+        for (int i = 0; i < 20; ++i) {
+            long_input.push_back(0x01);
+        }
+        ByteReader long_batch(long_input);
+        Vector<uint64_t> sink(20);
+        CHECK_THROWS(long_batch.read_varints(sink.data(), 20), std::invalid_argument);
+    }
+
+    return test::result();
+}
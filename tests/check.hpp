@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdio>
+
+// Checks for the standalone test programs in this directory. A failed check prints its location
+// and keeps going; main() returns test::result() so the process exits non-zero on any failure.
+namespace test {
+
+inline int failures = 0;
+
+inline void fail(const char* file, int line, const char* what) {
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what);
+    ++failures;
+}
+
+inline int result() {
+    if (failures != 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace test
+
+#define CHECK(cond)                                  \
+    do {                                             \
+        if (!(cond)) {                               \
+            test::fail(__FILE__, __LINE__, #cond);   \
+        }                                            \
+    } while (0)
+
+#define CHECK_THROWS(expr, Exception)                                          \
+    do {                                                                       \
+        bool caught_ = false;                                                  \
+        try {                                                                  \
+            (void)(expr);                                                      \
+        } catch (const Exception&) {                                           \
+            caught_ = true;                                                    \
+        } catch (...) {                                                        \
+        }                                                                      \
+        if (!caught_) {                                                        \
+            test::fail(__FILE__, __LINE__, #expr " throws " #Exception);       \
+        }                                                                      \
+    } while (0)
@@ -0,0 +1,115 @@
+#include "../cpuDispatch.hpp"
+#include "../parseNumbers.hpp"
+#include "../vectorDiff.hpp"
+#include "check.hpp"
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+int level_zero() { return 0; }
+int level_one() { return 1; }
+int level_two() { return 2; }
+int level_three() { return 3; }
+
+// The index select_kernel should pick: the highest non-null slot not above the running level.
+int expected_slot(const bool present[4]) {
+    for (int i = static_cast<int>(cpu_level()); i > 0; --i) {
+        if (present[i]) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+int main() {
+    // cpu_level() honours the environment it saw first and never changes afterwards.
+    CpuLevel detected = detail::detect_cpu_level();
+    CpuLevel first = cpu_level();
+    CHECK(first == detail::resolve_cpu_level());
+    CHECK(first <= detected);
+
+    CHECK(std::strcmp(cpu_level_name(CpuLevel::Scalar), "scalar") == 0);
+    CHECK(std::strcmp(cpu_level_name(CpuLevel::SSE42), "sse4.2") == 0);
+    CHECK(std::strcmp(cpu_level_name(CpuLevel::AVX2), "avx2") == 0);
+    CHECK(std::strcmp(cpu_level_name(CpuLevel::AVX512), "avx512") == 0);
+
+    // VECTOR_CPU_LEVEL lowers the level but never raises it; unknown names are ignored.
+    bool lowered = true;
+    for (int i = 0; i <= static_cast<int>(CpuLevel::AVX512); ++i) {
+        CpuLevel requested = static_cast<CpuLevel>(i);
+        setenv("VECTOR_CPU_LEVEL", cpu_level_name(requested), 1);
+        lowered = lowered && detail::resolve_cpu_level() == (requested < detected ? requested : detected);
+    }
+    CHECK(lowered);
+    setenv("VECTOR_CPU_LEVEL", "AVX2", 1);
+    CHECK(detail::resolve_cpu_level() == detected);
+    setenv("VECTOR_CPU_LEVEL", "", 1);
+    CHECK(detail::resolve_cpu_level() == detected);
+    unsetenv("VECTOR_CPU_LEVEL");
+    CHECK(detail::resolve_cpu_level() == detected);
+    CHECK(cpu_level() == first);
+
+    // Every pattern of missing levels falls back to the next lower one, ending at scalar.
+    bool selects = true;
+    for (int mask = 0; mask < 8; ++mask) {
+        bool present[4] = {true, (mask & 1) != 0, (mask & 2) != 0, (mask & 4) != 0};
+        int (*chosen)() = select_kernel(&level_zero, present[1] ? &level_one : nullptr,
+                                        present[2] ? &level_two : nullptr, present[3] ? &level_three : nullptr);
+        selects = selects && chosen() == expected_slot(present);
+    }
+    CHECK(selects);
+
+#if VECTOR_DISPATCH_X86
+    // Each compiled level of a kernel agrees with scalar on this CPU, whatever was selected.
+    const size_t n = 300;
+    uint8_t a[n];
+    uint8_t b[n];
+    char text[n];
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = b[i] = static_cast<uint8_t>(i * 13);
+        text[i] = (i % 37 == 5 || i % 91 == 0) ? ',' : static_cast<char>('0' + i % 10);
+    }
+    bool agree = true;
+    for (size_t diff = 0; diff <= n; diff += 7) {
+        if (diff < n) {
+            b[diff] ^= 1;
+        }
+        for (size_t len : {size_t(0), size_t(31), size_t(64), size_t(65), n}) {
+            size_t want = detail::mismatch_bytes_baseline(a, b, len);
+            if (detected >= CpuLevel::AVX2) {
+                agree = agree && detail::mismatch_bytes_avx2(a, b, len) == want;
+            }
+            if (detected >= CpuLevel::AVX512) {
+                agree = agree && detail::mismatch_bytes_avx512(a, b, len) == want;
+            }
+        }
+        if (diff < n) {
+            b[diff] ^= 1;
+        }
+    }
+    for (size_t start = 0; start < 80; ++start) {
+        const char* p = text + start;
+        const char* end = text + n;
+        const char* want_find = detail::find_separator_scalar(p, end, ',');
+        size_t want_count = detail::count_separators_scalar(p, end, ',');
+        if (detected >= CpuLevel::SSE42) {
+            agree = agree && detail::find_separator_sse42(p, end, ',') == want_find;
+            agree = agree && detail::count_separators_sse42(p, end, ',') == want_count;
+        }
+        if (detected >= CpuLevel::AVX2) {
+            agree = agree && detail::find_separator_avx2(p, end, ',') == want_find;
+            agree = agree && detail::count_separators_avx2(p, end, ',') == want_count;
+        }
+        if (detected >= CpuLevel::AVX512) {
+            agree = agree && detail::find_separator_avx512(p, end, ',') == want_find;
+            agree = agree && detail::count_separators_avx512(p, end, ',') == want_count;
+        }
+    }
+    CHECK(agree);
+#endif
+
+    return test::result();
+}
@@ -0,0 +1,115 @@
+#include "../customVector.hpp"
+#include "check.hpp"
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+struct Tracked {
+    static inline int live = 0;
+    static inline int copies = 0;
+    int value;
+
+    explicit Tracked(int v) : value(v) { ++live; }
+    Tracked(const Tracked& other) : value(other.value) { ++live; ++copies; }
+    Tracked(Tracked&& other) noexcept : value(other.value) { ++live; }
+    ~Tracked() { --live; }
+};
+
+} // namespace
+
+int main() {
+    // release() hands over the exact buffer and leaves the Vector empty but usable; adopt()
+    // takes it back without touching the elements.
+    {
+        Vector<std::string> words;
+        words.reserve(8);
+        words.push_back("one");
+        words.push_back("two");
+        const std::string* storage = words.data();
+        Vector<std::string>::Buffer buffer = words.release();
+        CHECK(buffer.ptr == storage && buffer.size == 2 && buffer.capacity == 8);
+        CHECK(words.empty() && words.capacity() == 0 && words.data() == nullptr);
+        words.push_back("three");
+        CHECK(words.size() == 1 && words[0] == "three");
+
+        Vector<std::string> adopted = Vector<std::string>::adopt(buffer.ptr, buffer.size, buffer.capacity);
+        CHECK(adopted.data() == storage && adopted.size() == 2 && adopted.capacity() == 8);
+        CHECK(adopted[1] == "two");
+        adopted.push_back("four");
+        CHECK(adopted.data() == storage && adopted.size() == 3);
+    }
+
+    // Inconsistent buffers are rejected; an empty adopt is fine.
+    {
+        int storage[4] = {};
+        using IntVector = Vector<int>;
+        CHECK_THROWS(IntVector::adopt(storage, 5, 4), std::invalid_argument);
+        CHECK_THROWS(IntVector::adopt(nullptr, 0, 4), std::invalid_argument);
+        IntVector empty = IntVector::adopt(nullptr, 0, 0);
+        CHECK(empty.empty() && empty.capacity() == 0);
+    }
+
+    // unique_ptr round trip: no element is copied, and the deleter destroys exactly the
+    // constructed elements when the unique_ptr is dropped instead of converted back.
+    {
+        Vector<Tracked> values;
+        values.reserve(16);
+        for (int i = 0; i < 10; ++i) {
+            values.emplace_back(i);
+        }
+        int copies_before = Tracked::copies;
+        const Tracked* storage = values.data();
+        Vector<Tracked>::UniquePtr owned = values.to_unique_ptr();
+        CHECK(values.empty() && values.data() == nullptr);
+        CHECK(owned.get() == storage && owned.get_deleter().size() == 10 && owned.get_deleter().capacity() == 16);
+        CHECK(owned[9].value == 9);
+
+        Vector<Tracked> back = Vector<Tracked>::from_unique_ptr(std::move(owned));
+        CHECK(owned == nullptr);
+        CHECK(back.data() == storage && back.size() == 10 && back.capacity() == 16);
+        CHECK(Tracked::copies == copies_before);
+
+        Vector<Tracked>::UniquePtr dropped = back.to_unique_ptr();
+        CHECK(Tracked::live == 10);
+        dropped.reset();
+        CHECK(Tracked::live == 0);
+    }
+
+    // An empty Vector converts to a null unique_ptr and back.
+    {
+        Vector<int> empty;
+        Vector<int>::UniquePtr owned = empty.to_unique_ptr();
+        CHECK(owned == nullptr);
+        Vector<int> back = Vector<int>::from_unique_ptr(std::move(owned));
+        CHECK(back.empty() && back.capacity() == 0);
+    }
+
+    // std::unique_ptr<T[]> from new[] moves in and out through ArrayNewAllocator, including
+    // after the Vector has grown and reallocated.
+    {
+        std::unique_ptr<int[]> raw(new int[4]{1, 2, 3, 4});
+        const int* storage = raw.get();
+        Vector<int, ArrayNewAllocator<int>> vec = from_unique_ptr(std::move(raw), 4);
+        CHECK(raw == nullptr && vec.data() == storage && vec.size() == 4 && vec[3] == 4);
+        for (int i = 5; i <= 100; ++i) {
+            vec.push_back(i);
+        }
+        std::unique_ptr<int[]> out = to_unique_ptr(std::move(vec));
+        CHECK(vec.empty());
+        CHECK(out[0] == 1 && out[99] == 100);
+    }
+
+    // The range constructor no longer captures (count, value) integer pairs.
+    {
+        Vector<int> filled(5, 7);
+        CHECK(filled.size() == 5 && filled[4] == 7);
+        int source[3] = {4, 5, 6};
+        Vector<int> ranged(source, source + 3);
+        CHECK(ranged.size() == 3 && ranged.capacity() == 3 && ranged[2] == 6);
+    }
+
+    CHECK(Tracked::live == 0);
+    return test::result();
+}
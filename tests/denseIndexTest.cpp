@@ -0,0 +1,168 @@
+#include "../denseIndex.hpp"
+#include "check.hpp"
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+Vector<float> random_rows(size_t n, size_t dim, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    Vector<float> out(n * dim);
+    for (size_t i = 0; i < out.size(); ++i) {
+        out[i] = dist(rng);
+    }
+    return out;
+}
+
+// Scores in the index's convention: L2 is squared distance (smaller is better), the others are
+// similarities (larger is better).
+float reference_score(Metric metric, const float* q, const float* x, size_t dim) {
+    double dot = 0.0, qq = 0.0, xx = 0.0, l2 = 0.0;
+    for (size_t i = 0; i < dim; ++i) {
+        dot += double(q[i]) * x[i];
+        qq += double(q[i]) * q[i];
+        xx += double(x[i]) * x[i];
+        l2 += (double(q[i]) - x[i]) * (double(q[i]) - x[i]);
+    }
+    switch (metric) {
+    case Metric::L2:
+        return float(l2);
+    case Metric::InnerProduct:
+        return float(dot);
+    case Metric::Cosine:
+        return float(dot / std::sqrt(qq * xx));
+    }
+    return 0.0f;
+}
+
+bool better(Metric metric, float a, float b) { return metric == Metric::L2 ? a < b : a > b; }
+
+// Every returned neighbor must score within tolerance of the brute-force score for its id, the
+// list must be ordered best first, and nothing outside the list may beat its last entry.
+bool matches_brute_force(const DenseIndex& index, const float* queries, size_t nq, size_t k,
+                         const Vector<Neighbor>& results) {
+    size_t dim = index.dim();
+    if (results.size() != nq * k) {
+        return false;
+    }
+    const float tolerance = 1e-3f;
+    for (size_t q = 0; q < nq; ++q) {
+        const float* query = queries + q * dim;
+        const Neighbor* got = results.data() + q * k;
+        Vector<uint8_t> taken(index.size(), 0);
+        for (size_t i = 0; i < k; ++i) {
+            if (got[i].id >= index.size() || taken[got[i].id]) {
+                return false;
+            }
+            taken[got[i].id] = 1;
+            float expected = reference_score(index.metric(), query, index.row(got[i].id), dim);
+            if (std::fabs(expected - got[i].score) > tolerance) {
+                return false;
+            }
+            if (i > 0 && better(index.metric(), got[i].score, got[i - 1].score) &&
+                std::fabs(got[i].score - got[i - 1].score) > tolerance) {
+                return false;
+            }
+        }
+        float worst = got[k - 1].score;
+        for (size_t r = 0; r < index.size(); ++r) {
+            float score = reference_score(index.metric(), query, index.row(r), dim);
+            if (!taken[r] && better(index.metric(), score, worst) && std::fabs(score - worst) > tolerance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    CHECK_THROWS(DenseIndex(0), std::invalid_argument);
+
+    // Dimensions off the SIMD widths, a row count spanning several row tiles, and query counts
+    // that do not fill the last query tile.
+    const size_t dims[] = {1, 7, 19, 64};
+    const Metric metrics[] = {Metric::L2, Metric::InnerProduct, Metric::Cosine};
+    for (size_t dim : dims) {
+        for (Metric metric : metrics) {
+            DenseIndex index(dim, metric);
+            CHECK(index.dim() == dim && index.metric() == metric && index.size() == 0);
+            Vector<float> rows = random_rows(600, dim, unsigned(dim));
+            index.reserve(600);
+            CHECK(index.add(rows.data()) == 0);
+            index.add(rows.data() + dim, 599);
+            CHECK(index.size() == 600);
+            CHECK(index.rows().size() == 600 * dim);
+            CHECK(index.row(599)[0] == rows[599 * dim]);
+
+            Vector<float> queries = random_rows(11, dim, unsigned(dim) + 100);
+            Vector<Neighbor> single = index.search(queries.data(), 11, 10, 1);
+            CHECK(matches_brute_force(index, queries.data(), 11, 10, single));
+
+            Vector<Neighbor> parallel = index.search(queries, 10, 3);
+            bool same = parallel.size() == single.size();
+            for (size_t i = 0; same && i < single.size(); ++i) {
+                same = parallel[i].id == single[i].id && parallel[i].score == single[i].score;
+            }
+            CHECK(same);
+
+            Vector<Neighbor> one = index.search(queries.data() + 5 * dim, 10);
+            bool same_row = one.size() == 10;
+            for (size_t i = 0; same_row && i < 10; ++i) {
+                same_row = one[i].id == single[5 * 10 + i].id;
+            }
+            CHECK(same_row);
+        }
+    }
+
+    // A row searched for itself is its own nearest neighbor.
+    {
+        DenseIndex index(8);
+        Vector<float> rows = random_rows(50, 8, 7);
+        index.add(rows);
+        Vector<Neighbor> hit = index.search(rows.data() + 17 * 8, 1);
+        CHECK(hit.size() == 1 && hit[0].id == 17 && hit[0].score < 1e-4f);
+    }
+
+    // k is clamped to size(); an empty index, k == 0 and nq == 0 give empty results.
+    {
+        DenseIndex index(4, Metric::InnerProduct);
+        Vector<float> query = random_rows(1, 4, 3);
+        CHECK(index.search(query.data(), 5).size() == 0);
+        Vector<float> rows = random_rows(3, 4, 4);
+        index.add(rows);
+        Vector<Neighbor> all = index.search(query.data(), 10);
+        CHECK(all.size() == 3);
+        CHECK(matches_brute_force(index, query.data(), 1, 3, all));
+        CHECK(index.search(query.data(), 0).size() == 0);
+        CHECK(index.search(query.data(), 0, 2, 4).size() == 0);
+        CHECK(index.search(Vector<float>(), 2).size() == 0);
+    }
+
+    // A zero query under cosine has no direction; it must not produce NaN scores.
+    {
+        DenseIndex index(3, Metric::Cosine);
+        Vector<float> rows = random_rows(5, 3, 9);
+        index.add(rows);
+        float zero[3] = {0.0f, 0.0f, 0.0f};
+        Vector<Neighbor> hits = index.search(zero, 5);
+        bool finite = hits.size() == 5;
+        for (size_t i = 0; finite && i < hits.size(); ++i) {
+            finite = std::isfinite(hits[i].score);
+        }
+        CHECK(finite);
+    }
+
+    // Inputs that are not a whole number of rows are rejected.
+    {
+        DenseIndex index(4);
+        CHECK_THROWS(index.add(Vector<float>(6, 1.0f)), std::invalid_argument);
+        CHECK(index.size() == 0);
+        index.add(Vector<float>(8, 1.0f));
+        CHECK_THROWS(index.search(Vector<float>(5, 1.0f), 1), std::invalid_argument);
+    }
+
+    return test::result();
+}
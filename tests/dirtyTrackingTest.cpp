@@ -0,0 +1,167 @@
+#include "../dirtyTracking.hpp"
+#include "check.hpp"
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+using Tracked = DirtyTrackedVector<uint32_t>;
+
+struct Region {
+    size_t first;
+    size_t count;
+};
+
+Vector<Region> regions(const Tracked& vec) {
+    Vector<Region> out;
+    vec.for_each_dirty_region([&](size_t first, size_t count) { out.push_back({first, count}); });
+    return out;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+bool file_matches(std::FILE* file, const Tracked& vec, long base) {
+    std::fflush(file);
+    std::fseek(file, 0, SEEK_END);
+    if (std::ftell(file) != base + static_cast<long>(vec.size() * sizeof(uint32_t))) {
+        return false;
+    }
+    std::fseek(file, base, SEEK_SET);
+    Vector<uint32_t> image(vec.size());
+    if (std::fread(image.data(), sizeof(uint32_t), image.size(), file) != image.size()) {
+        return false;
+    }
+    return image == vec.values();
+}
+#endif
+
+} // namespace
+
+int main() {
+    // Tracked writes mark exactly their chunks; runs of dirty chunks merge into one region and
+    // the last region is clipped to size().
+    {
+        Tracked vec(16); // four elements per chunk
+        CHECK(vec.chunk_elements() == 4);
+        vec.resize(30);
+        CHECK(vec.chunk_count() == 8 && vec.dirty_chunk_count() == 8);
+        vec.clear_dirty();
+        CHECK(vec.dirty_chunk_count() == 0 && regions(vec).empty() && vec.dirty_bytes() == 0);
+
+        vec.set(5, 1);
+        vec.mutable_at(9) = 2;
+        vec.mutable_range(28, 2)[1] = 3;
+        CHECK(vec[9] == 2 && vec[29] == 3);
+        CHECK(vec.is_chunk_dirty(1) && vec.is_chunk_dirty(2) && vec.is_chunk_dirty(7) && !vec.is_chunk_dirty(0));
+        Vector<Region> found = regions(vec);
+        CHECK(found.size() == 2);
+        CHECK(found[0].first == 4 && found[0].count == 8);
+        CHECK(found[1].first == 28 && found[1].count == 2);
+        CHECK(vec.dirty_bytes() == 10 * sizeof(uint32_t));
+
+        vec.push_back(4);
+        CHECK(vec.size() == 31 && vec.is_chunk_dirty(7));
+        vec.mutable_range(0, 0);
+        CHECK(vec.dirty_chunk_count() == 3);
+    }
+
+    // Bulk marking across bitmap words, including whole-word spans, matches chunk-by-chunk.
+    {
+        Tracked vec(4); // one element per chunk
+        vec.resize(300);
+        for (size_t first : {size_t(0), size_t(1), size_t(63), size_t(64), size_t(100)}) {
+            for (size_t n : {size_t(1), size_t(64), size_t(65), size_t(128), size_t(200)}) {
+                if (first + n > vec.size()) {
+                    continue;
+                }
+                vec.clear_dirty();
+                vec.mark_dirty(first, n);
+                bool exact = vec.dirty_chunk_count() == n;
+                for (size_t c = 0; c < vec.chunk_count(); ++c) {
+                    exact = exact && vec.is_chunk_dirty(c) == (c >= first && c < first + n);
+                }
+                CHECK(exact);
+                Vector<Region> found = regions(vec);
+                CHECK(found.size() == 1 && found[0].first == first && found[0].count == n);
+            }
+        }
+    }
+
+    // Out-of-range tracked writes and marks throw and mark nothing.
+    {
+        Tracked vec(16);
+        vec.resize(10);
+        vec.clear_dirty();
+        CHECK_THROWS(vec.set(10, 1), std::out_of_range);
+        CHECK_THROWS(vec.mutable_at(100), std::out_of_range);
+        CHECK_THROWS(vec.mutable_range(8, 3), std::out_of_range);
+        CHECK_THROWS(vec.mutable_range(size_t(-1), 2), std::out_of_range);
+        CHECK_THROWS(vec.mark_dirty(9, 2), std::out_of_range);
+        CHECK_THROWS(vec.mark_dirty(1000, 1), std::out_of_range);
+        CHECK(vec.dirty_chunk_count() == 0);
+    }
+
+    // A Vector handed in starts fully dirty; shrinking drops chunks past the end from regions.
+    {
+        Vector<uint32_t> values(100, 7);
+        Tracked vec(std::move(values), 40);
+        CHECK(vec.size() == 100 && vec.dirty_chunk_count() == 10);
+        vec.resize(25);
+        Vector<Region> found = regions(vec);
+        CHECK(found.size() == 1 && found[0].first == 0 && found[0].count == 25);
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    // Random edits checkpointed to a file at an offset: after every checkpoint the file holds
+    // exactly the current contents, and each checkpoint writes only the dirty regions.
+    {
+        std::FILE* file = std::tmpfile();
+        CHECK(file != nullptr);
+        if (file != nullptr) {
+            const long base = 100;
+            std::mt19937 rng(3);
+            Tracked vec(64);
+            vec.resize(1000);
+            bool all_match = true;
+            bool minimal = true;
+            for (int round = 0; round < 40; ++round) {
+                int edits = static_cast<int>(rng() % 6);
+                for (int e = 0; e < edits; ++e) {
+                    switch (rng() % 4) {
+                    case 0:
+                        if (!vec.empty()) {
+                            vec.set(rng() % vec.size(), static_cast<uint32_t>(rng()));
+                        }
+                        break;
+                    case 1:
+                        vec.push_back(static_cast<uint32_t>(rng()));
+                        break;
+                    case 2:
+                        vec.resize(rng() % 1500, static_cast<uint32_t>(round));
+                        break;
+                    default:
+                        if (vec.size() > 50) {
+                            uint32_t* p = vec.mutable_range(10, 40);
+                            p[39] = static_cast<uint32_t>(rng());
+                        }
+                        break;
+                    }
+                }
+                size_t expected_bytes = vec.dirty_bytes();
+                size_t written = vec.checkpoint(fileno(file), base);
+                minimal = minimal && written == expected_bytes && vec.dirty_chunk_count() == 0;
+                all_match = all_match && file_matches(file, vec, base);
+            }
+            CHECK(all_match);
+            CHECK(minimal);
+            CHECK(vec.checkpoint(fileno(file), base) == 0);
+            std::fclose(file);
+        }
+        Tracked vec;
+        vec.push_back(1);
+        CHECK_THROWS(vec.checkpoint(-1), std::system_error);
+    }
+#endif
+
+    return test::result();
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdlib>
+#include <new>
+
+// Replaces the global operator new for a test program so that it can make one specific
+// allocation fail: set allocations_until_failure to n and the (n + 1)-th allocation from then on
+// throws std::bad_alloc. -1 disables the countdown. Include from exactly one file per program.
+namespace test {
+inline long allocations_until_failure = -1;
+}
+
+// noinline keeps GCC from pairing the inlined malloc/free with new/delete expressions and
+// warning about a mismatch.
+__attribute__((noinline)) void* operator new(std::size_t size) {
+    if (test::allocations_until_failure >= 0 && test::allocations_until_failure-- == 0) {
+        throw std::bad_alloc();
+    }
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept { std::free(p); }
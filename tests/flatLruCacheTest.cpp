@@ -0,0 +1,127 @@
+#include "../flatLruCache.hpp"
+#include "check.hpp"
+#include <list>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+// Reference LRU model: front is most recently used.
+struct ModelLru {
+    size_t capacity;
+    std::list<std::pair<int, int>> order;
+    std::unordered_map<int, std::list<std::pair<int, int>>::iterator> index;
+
+    const int* get(int key) {
+        auto it = index.find(key);
+        if (it == index.end()) {
+            return nullptr;
+        }
+        order.splice(order.begin(), order, it->second);
+        return &it->second->second;
+    }
+
+    void put(int key, int value) {
+        if (get(key) != nullptr) {
+            order.front().second = value;
+            return;
+        }
+        if (order.size() == capacity) {
+            index.erase(order.back().first);
+            order.pop_back();
+        }
+        order.emplace_front(key, value);
+        index[key] = order.begin();
+    }
+
+    bool erase(int key) {
+        auto it = index.find(key);
+        if (it == index.end()) {
+            return false;
+        }
+        order.erase(it->second);
+        index.erase(it);
+        return true;
+    }
+};
+
+// Every key hashes to one of a few values, so probe runs are long and deletion has to shift.
+struct CollidingHash {
+    size_t operator()(int key) const { return static_cast<size_t>(key % 3); }
+};
+
+} // namespace
+
+int main() {
+    using IntCache = FlatLruCache<int, int>;
+    CHECK_THROWS(IntCache(0), std::invalid_argument);
+    CHECK_THROWS(IntCache(size_t(1) << 31), std::invalid_argument);
+
+    // Recency order, overwrite, eviction of the least recently used entry.
+    FlatLruCache<int, std::string> cache(3);
+    CHECK(cache.put(1, "one") && cache.put(2, "two") && cache.put(3, "three"));
+    CHECK(!cache.put(2, "TWO"));
+    CHECK(cache.get(1) != nullptr);
+    CHECK(cache.put(4, "four"));
+    CHECK(!cache.contains(3) && cache.size() == 3);
+    CHECK(*cache.peek(2) == "TWO");
+    Vector<int> order;
+    cache.for_each([&](int key, const std::string&) { order.push_back(key); });
+    CHECK((order == Vector<int>{4, 1, 2}));
+    CHECK(cache.erase(1) && !cache.erase(1) && cache.size() == 2);
+    cache.clear();
+    CHECK(cache.empty() && cache.get(4) == nullptr);
+    CHECK(cache.put(5, "five") && *cache.get(5) == "five");
+
+    // Random operations against the model, with heavy hash collisions.
+    std::mt19937 rng(11);
+    for (size_t capacity : {1, 2, 7, 64}) {
+        FlatLruCache<int, int, CollidingHash> flat(capacity);
+        ModelLru model{capacity, {}, {}};
+        bool same = true;
+        for (int step = 0; step < 20000 && same; ++step) {
+            int key = static_cast<int>(rng() % (capacity * 3 + 1));
+            switch (rng() % 3) {
+            case 0: {
+                int value = static_cast<int>(rng());
+                CHECK(flat.put(key, value) == (model.index.count(key) == 0));
+                model.put(key, value);
+                break;
+            }
+            case 1: {
+                const int* a = flat.get(key);
+                const int* b = model.get(key);
+                same = (a == nullptr) == (b == nullptr) && (a == nullptr || *a == *b);
+                break;
+            }
+            default:
+                same = flat.erase(key) == model.erase(key);
+                break;
+            }
+            same = same && flat.size() == model.order.size();
+        }
+        CHECK(same);
+    }
+
+    // CLOCK: a referenced entry survives one sweep, an unreferenced one is evicted.
+    IntCache clock(3, EvictionPolicy::Clock);
+    clock.put(1, 1);
+    clock.put(2, 2);
+    clock.put(3, 3);
+    CHECK(clock.get(1) != nullptr);
+    clock.put(4, 4);
+    CHECK(clock.contains(1) && !clock.contains(2) && clock.contains(3) && clock.contains(4));
+    CHECK(clock.policy() == EvictionPolicy::Clock && clock.size() == 3);
+
+    // A moved-from cache misses on lookups and refuses inserts instead of reading out of bounds.
+    FlatLruCache<int, std::string> moved(std::move(cache));
+    CHECK(*moved.get(5) == "five" && moved.capacity() == 3);
+    CHECK(cache.capacity() == 0 && cache.empty());
+    CHECK(cache.get(5) == nullptr && cache.peek(5) == nullptr && !cache.contains(5) && !cache.erase(5));
+    CHECK_THROWS(cache.put(6, "six"), std::logic_error);
+    cache.clear();
+
+    return test::result();
+}
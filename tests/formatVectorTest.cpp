@@ -0,0 +1,173 @@
+#include "../formatVector.hpp"
+#include "check.hpp"
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <system_error>
+
+namespace {
+
+std::string text(const Vector<char>& buffer) { return std::string(buffer.data(), buffer.size()); }
+
+#if defined(__unix__) || defined(__APPLE__)
+std::string read_back(std::FILE* file) {
+    std::fflush(file);
+    std::rewind(file);
+    std::string out;
+    char chunk[4096];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        out.append(chunk, n);
+    }
+    return out;
+}
+#endif
+
+} // namespace
+
+int main() {
+    // Element kinds: integers at their limits, bool, char as a character, int8_t as a number and
+    // string-like elements.
+    {
+        Vector<char> buffer;
+        Vector<int64_t> ints;
+        ints.push_back(std::numeric_limits<int64_t>::min());
+        ints.push_back(0);
+        ints.push_back(std::numeric_limits<int64_t>::max());
+        format_to(buffer, ints);
+        CHECK(text(buffer) == "-9223372036854775808 0 9223372036854775807\n");
+
+        buffer.clear();
+        bool flags[2] = {true, false};
+        format_to(buffer, flags, 2, FormatSpec{",", "[", "]"});
+        CHECK(text(buffer) == "[true,false]");
+
+        buffer.clear();
+        char letters[3] = {'a', 'b', 'c'};
+        format_to(buffer, letters, 3, FormatSpec{"", "", ""});
+        CHECK(text(buffer) == "abc");
+
+        buffer.clear();
+        int8_t small[2] = {-5, 100};
+        format_to(buffer, small, 2);
+        CHECK(text(buffer) == "-5 100\n");
+
+        buffer.clear();
+        Vector<std::string> words;
+        words.push_back("alpha");
+        words.push_back("");
+        words.push_back("gamma");
+        format_to(buffer, words, FormatSpec{"|", "<", ">"});
+        CHECK(text(buffer) == "<alpha||gamma>");
+    }
+
+    // Shortest float output round-trips exactly; fixed precision and scientific are honoured.
+    {
+        Vector<char> buffer;
+        Vector<double> values;
+        values.push_back(0.1);
+        values.push_back(-1e300);
+        values.push_back(std::numeric_limits<double>::denorm_min());
+        values.push_back(1.0 / 3.0);
+        format_to(buffer, values, FormatSpec{" ", "", ""});
+        const char* p = buffer.data();
+        const char* end = p + buffer.size();
+        bool exact = true;
+        for (size_t i = 0; i < values.size(); ++i) {
+            double parsed = 0;
+            std::from_chars_result r = std::from_chars(p, end, parsed);
+            exact = exact && r.ec == std::errc() && parsed == values[i];
+            p = r.ptr + (r.ptr < end ? 1 : 0);
+        }
+        CHECK(exact);
+
+        buffer.clear();
+        float f[2] = {1.5f, 2.0f};
+        FormatSpec fixed;
+        fixed.float_format = std::chars_format::fixed;
+        fixed.precision = 3;
+        fixed.suffix = "";
+        format_to(buffer, f, 2, fixed);
+        CHECK(text(buffer) == "1.500 2.000");
+
+        // Precision wide enough to need more than the initial per-value room.
+        buffer.clear();
+        fixed.precision = 200;
+        format_to(buffer, f, 1, fixed);
+        CHECK(buffer.size() == 202 && buffer[0] == '1' && buffer[201] == '0');
+
+        buffer.clear();
+        double big = 1e300;
+        FormatSpec wide;
+        wide.float_format = std::chars_format::fixed;
+        wide.suffix = "";
+        format_to(buffer, &big, 1, wide);
+        CHECK(buffer.size() == 301 && buffer[0] == '1');
+    }
+
+    // format_to appends to existing content; empty input still writes prefix and suffix; a
+    // reused buffer stops reallocating.
+    {
+        Vector<char> buffer;
+        buffer.push_back('>');
+        int one = 1;
+        format_to(buffer, &one, 1);
+        CHECK(text(buffer) == ">1\n");
+        format_to(buffer, &one, 0, FormatSpec{",", "[", "]"});
+        CHECK(text(buffer) == ">1\n[]");
+
+        Vector<int> many(1000, 123456);
+        buffer.clear();
+        format_to(buffer, many);
+        const char* storage = buffer.data();
+        size_t size = buffer.size();
+        CHECK(size == 1000 * 7);
+        buffer.clear();
+        format_to(buffer, many);
+        CHECK(buffer.data() == storage && buffer.size() == size);
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    // write_text flushes in blocks; the file matches format_to for inputs spanning many flushes,
+    // a single element and an empty vector.
+    {
+        Vector<uint32_t> large;
+        for (uint32_t i = 0; i < 300000; ++i) {
+            large.push_back(i * 2654435761u);
+        }
+        FormatSpec spec{", ", "{", "}\n"};
+        Vector<char> expected;
+        format_to(expected, large, spec);
+
+        std::FILE* file = std::tmpfile();
+        CHECK(file != nullptr);
+        if (file != nullptr) {
+            Vector<char> scratch;
+            write_text(fileno(file), large, scratch, spec);
+            CHECK(scratch.empty());
+            CHECK(read_back(file) == text(expected));
+            std::fclose(file);
+        }
+
+        for (size_t n : {size_t(0), size_t(1)}) {
+            Vector<uint32_t> small(large.data(), large.data() + n);
+            Vector<char> want;
+            format_to(want, small, spec);
+            std::FILE* f = std::tmpfile();
+            if (f != nullptr) {
+                write_text(fileno(f), small, spec);
+                CHECK(read_back(f) == text(want));
+                std::fclose(f);
+            }
+        }
+    }
+
+    // Write errors surface as std::system_error.
+    {
+        Vector<int> values(3, 1);
+        CHECK_THROWS(write_text(-1, values), std::system_error);
+    }
+#endif
+
+    return test::result();
+}
@@ -0,0 +1,108 @@
+#include "../frozenVector.hpp"
+#include "check.hpp"
+#include <stdexcept>
+
+namespace {
+
+#if VECTOR_HAS_CONSTEXPR_ALLOCATION
+
+// Growth, copies, moves, shrinking and iteration all run during constant evaluation; any leak or
+// out-of-lifetime access would make these static_asserts ill-formed.
+constexpr int exercise_vector() {
+    Vector<int> v;
+    for (int i = 0; i < 100; ++i) {
+        v.push_back(i);
+    }
+    v.pop_back();
+    Vector<int> copy = v;
+    Vector<int> moved = std::move(copy);
+    moved.resize(120, 5);
+    moved.resize(110);
+    moved.shrink_to_fit();
+    int total = 0;
+    for (auto it = moved.cbegin(); it != moved.cend(); ++it) {
+        total += *it;
+    }
+    for (int x : v) {
+        total -= x;
+    }
+    Vector<int> assigned;
+    assigned = moved;
+    assigned = {1, 2, 3};
+    return total + static_cast<int>(moved.size() + moved.capacity()) + assigned.back() + (v == moved ? 1000 : 0);
+}
+static_assert(exercise_vector() == 11 * 5 + 110 + 110 + 3);
+
+constexpr Vector<unsigned> crc_table_vector() {
+    Vector<unsigned> table;
+    table.reserve(256);
+    for (unsigned n = 0; n < 256; ++n) {
+        unsigned c = n;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table.push_back(c);
+    }
+    return table;
+}
+
+static constexpr auto kCrcTable = freeze<256>(crc_table_vector());
+static constexpr auto kSquares = freeze([] {
+    Vector<int> v;
+    for (int i = 1; i <= 10; ++i) {
+        v.push_back(i * i);
+    }
+    return v;
+});
+static constexpr auto kEmpty = freeze([] { return Vector<int>(); });
+
+static_assert(kCrcTable.size() == 256 && kCrcTable[1] == 0x77073096u && kCrcTable.back() == 0x2D02EF8Du);
+static_assert(kSquares.size() == 10 && kSquares.front() == 1 && kSquares.at(9) == 100);
+static_assert(kEmpty.empty() && kEmpty.begin() == kEmpty.end());
+
+#endif
+
+constexpr int kPrimes[5] = {2, 3, 5, 7, 11};
+static constexpr FrozenVector<int, 5> kFrozenPrimes(kPrimes);
+static_assert(kFrozenPrimes[4] == 11 && kFrozenPrimes.capacity() == 5);
+static_assert(kFrozenPrimes == FrozenVector<int, 5>(kPrimes));
+static_assert(kFrozenPrimes != FrozenVector<int, 5>());
+
+} // namespace
+
+int main() {
+    // Runtime use of the same paths, plus the errors a constant expression cannot show.
+    CHECK_THROWS(kFrozenPrimes.at(5), std::out_of_range);
+    CHECK(kFrozenPrimes.at(0) == 2);
+
+    Vector<int> thawed = kFrozenPrimes.thaw();
+    CHECK(thawed.size() == 5 && thawed == kFrozenPrimes && kFrozenPrimes == thawed);
+    thawed.push_back(13);
+    CHECK(!(thawed == kFrozenPrimes));
+    thawed.pop_back();
+    thawed[0] = 1;
+    CHECK(!(kFrozenPrimes == thawed));
+
+    int sum = 0;
+    for (auto it = thawed.cbegin(); it != thawed.cend(); ++it) {
+        sum += *it;
+    }
+    CHECK(sum == 1 + 3 + 5 + 7 + 11);
+
+#if VECTOR_HAS_CONSTEXPR_ALLOCATION
+    CHECK(exercise_vector() == 11 * 5 + 110 + 110 + 3);
+    unsigned crc = 0xFFFFFFFFu;
+    const char* text = "123456789";
+    for (const char* p = text; *p != '\0'; ++p) {
+        crc = kCrcTable[(crc ^ static_cast<unsigned char>(*p)) & 0xFF] ^ (crc >> 8);
+    }
+    CHECK((crc ^ 0xFFFFFFFFu) == 0xCBF43926u);
+
+    Vector<int> wrong(3, 1);
+    using Frozen4 = FrozenVector<int, 4>;
+    CHECK_THROWS(Frozen4(freeze<4>(wrong)), std::length_error);
+    CHECK(freeze<3>(wrong) == wrong);
+#endif
+
+    return test::result();
+}
@@ -0,0 +1,145 @@
+#include "../histogram.hpp"
+#include "check.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+template <typename T>
+Vector<uint64_t> reference_histogram(const Vector<T>& values, size_t bins, T lo, T hi) {
+    Vector<uint64_t> counts(bins, 0);
+    double scale = static_cast<double>(bins) / (static_cast<double>(hi) - static_cast<double>(lo));
+    for (size_t i = 0; i < values.size(); ++i) {
+        T v = values[i];
+        if (!(v >= lo && v <= hi)) {
+            continue;
+        }
+        size_t b = static_cast<size_t>((static_cast<double>(v) - static_cast<double>(lo)) * scale);
+        ++counts[std::min(b, bins - 1)];
+    }
+    return counts;
+}
+
+template <typename T>
+Vector<uint16_t> reference_bucketize(const Vector<T>& values, const Vector<T>& boundaries) {
+    Vector<uint16_t> out;
+    for (size_t i = 0; i < values.size(); ++i) {
+        const T* end = boundaries.data() + boundaries.size();
+        out.push_back(static_cast<uint16_t>(std::upper_bound(boundaries.data(), end, values[i]) - boundaries.data()));
+    }
+    return out;
+}
+
+// Bin edges computed in float and double can disagree by one ulp, so compare totals exactly
+// and allow a value to move to a neighbouring bin.
+bool close_counts(const Vector<uint64_t>& a, const Vector<uint64_t>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    uint64_t total_a = 0;
+    uint64_t total_b = 0;
+    uint64_t moved = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        total_a += a[i];
+        total_b += b[i];
+        moved += a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+    }
+    return total_a == total_b && moved <= total_a / 10000 + 2;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> uniform(-10.0f, 10.0f);
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    // Float input across the SIMD width boundaries and the multi-threaded split, with NaN and
+    // out-of-range values that must not be counted.
+    for (size_t n : {0, 1, 7, 8, 9, 31, 33, 1000, 300000}) {
+        Vector<float> values;
+        for (size_t i = 0; i < n; ++i) {
+            values.push_back(i % 97 == 5 ? nan : uniform(rng));
+        }
+        for (size_t bins : {1, 3, 64, 1000}) {
+            Vector<uint64_t> expected = reference_histogram(values, bins, -8.0f, 8.0f);
+            CHECK(close_counts(histogram(values, bins, -8.0f, 8.0f, 1), expected));
+            CHECK(histogram(values, bins, -8.0f, 8.0f, 4) == histogram(values, bins, -8.0f, 8.0f, 1));
+        }
+    }
+
+    // hi falls in the last bin; lo in the first; just outside falls nowhere.
+    Vector<double> edges{0.0, 1.0, 0.5, -1e-12, 1.0 + 1e-12};
+    CHECK((histogram(edges, 2, 0.0, 1.0) == Vector<uint64_t>{1, 2}));
+
+    // Integer input is exact.
+    Vector<int> ints;
+    for (int i = -50; i < 150; ++i) {
+        ints.push_back(i);
+    }
+    Vector<uint64_t> int_counts = histogram(ints, 10, 0, 100);
+    CHECK(int_counts == reference_histogram(ints, 10, 0, 100));
+    CHECK(int_counts[0] == 10 && int_counts[9] == 11);
+
+    // Range taken from the data.
+    CHECK((histogram(Vector<int>{3, 3, 3}, 4) == Vector<uint64_t>{3, 0, 0, 0}));
+    CHECK((histogram(Vector<float>{}, 2) == Vector<uint64_t>{0, 0}));
+    CHECK((histogram(Vector<float>{nan, nan}, 2) == Vector<uint64_t>{0, 0}));
+    CHECK((histogram(Vector<double>{1.0, 2.0, 3.0, 4.0}, 3) == Vector<uint64_t>{1, 1, 2}));
+
+    // Infinities are left out of the data range and of the counts, on the SIMD paths too.
+    const float inf = std::numeric_limits<float>::infinity();
+    CHECK((histogram(Vector<float>{0, 1, 2, inf}, 2) == Vector<uint64_t>{1, 2}));
+    CHECK((histogram(Vector<float>{-inf, inf, nan}, 2) == Vector<uint64_t>{0, 0}));
+    {
+        Vector<float> spiked;
+        for (int i = 0; i < 40; ++i) {
+            spiked.push_back(i % 5 == 0 ? (i % 2 == 0 ? inf : -inf) : static_cast<float>(i));
+        }
+        CHECK(histogram(spiked, 4) == reference_histogram(spiked, 4, 1.0f, 39.0f));
+    }
+
+    // Argument errors.
+    CHECK_THROWS(histogram(ints, 0, 0, 10), std::invalid_argument);
+    CHECK_THROWS(histogram(ints, 4, 10, 10), std::invalid_argument);
+    CHECK_THROWS(histogram(ints, 4, 10, 0), std::invalid_argument);
+    CHECK_THROWS(histogram(Vector<int>{1, 1}, 0), std::invalid_argument);
+    const float big = std::numeric_limits<float>::max();
+    CHECK_THROWS(histogram(Vector<float>{0}, 4, -inf, 1.0f), std::invalid_argument);
+    CHECK_THROWS(histogram(Vector<float>{0}, 4, 0.0f, inf), std::invalid_argument);
+    CHECK_THROWS(histogram(Vector<float>{0}, 4, -big, big), std::invalid_argument);
+    CHECK_THROWS(histogram(Vector<float>{-big, big}, 4), std::invalid_argument);
+
+    // bucketize against std::upper_bound, on both the linear (<= 16 boundaries) and the binary
+    // search paths, with duplicate boundaries and NaN.
+    for (size_t nb : {1, 2, 15, 16, 17, 100, 5000}) {
+        Vector<float> boundaries;
+        for (size_t i = 0; i < nb; ++i) {
+            boundaries.push_back(uniform(rng));
+        }
+        if (nb > 2) {
+            boundaries[1] = boundaries[0];
+        }
+        std::sort(boundaries.data(), boundaries.data() + boundaries.size());
+        Vector<float> values;
+        for (size_t i = 0; i < 200001; ++i) {
+            values.push_back(i % 50 == 0 ? boundaries[i % nb] : uniform(rng));
+        }
+        values[7] = nan;
+        Vector<uint16_t> expected = reference_bucketize(values, boundaries);
+        expected[7] = static_cast<uint16_t>(nb);
+        CHECK(bucketize(values, boundaries, 1) == expected);
+        CHECK(bucketize(values, boundaries, 4) == expected);
+    }
+    Vector<int> int_boundaries{0, 10, 10, 20};
+    CHECK((bucketize(Vector<int>{-5, 0, 9, 10, 19, 20, 99}, int_boundaries) == Vector<uint16_t>{0, 1, 1, 3, 3, 4, 4}));
+    CHECK((bucketize(Vector<int>{1, 2}, Vector<int>{}) == Vector<uint16_t>{0, 0}));
+    CHECK(bucketize(Vector<int>{}, int_boundaries).empty());
+    CHECK_THROWS(bucketize(ints, Vector<int>{3, 1}), std::invalid_argument);
+    CHECK_THROWS(bucketize(ints, Vector<int>(65536, 0)), std::length_error);
+
+    return test::result();
+}
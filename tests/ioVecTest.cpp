@@ -0,0 +1,198 @@
+#include "../ioVec.hpp"
+#include "check.hpp"
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+
+namespace {
+
+Vector<uint8_t> pattern(size_t n, uint8_t seed) {
+    Vector<uint8_t> out(n);
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = static_cast<uint8_t>(i * 7 + seed);
+    }
+    return out;
+}
+
+void drain(int fd, Vector<uint8_t>& into) {
+    uint8_t chunk[8192];
+    for (;;) {
+        ssize_t got = ::read(fd, chunk, sizeof(chunk));
+        if (got <= 0) {
+            return;
+        }
+        for (ssize_t i = 0; i < got; ++i) {
+            into.push_back(chunk[i]);
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    // A gather write larger than the pipe buffer on a non-blocking descriptor: partial writes
+    // resume mid-entry, a full pipe reports 0, and the reader sees the exact concatenation.
+    {
+        int fds[2];
+        CHECK(::pipe(fds) == 0);
+        ::fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        ::fcntl(fds[1], F_SETFL, O_NONBLOCK);
+
+        Vector<uint8_t> big = pattern(150000, 1);
+        Vector<uint32_t> words;
+        for (uint32_t i = 0; i < 20000; ++i) {
+            words.push_back(i);
+        }
+        ByteBuffer header;
+        header.put_u32(0xCAFEF00Du);
+        Vector<uint8_t> empty;
+
+        IoVecBuilder builder;
+        builder.add(header);
+        builder.add(empty);
+        builder.add(big);
+        builder.add(words);
+        builder.add("end", 3);
+        CHECK(builder.count() == 4);
+        size_t total = 4 + big.size() + words.size() * 4 + 3;
+        CHECK(builder.remaining_bytes() == total);
+
+        Vector<uint8_t> received;
+        size_t written = 0;
+        bool saw_full_pipe = false;
+        while (!builder.done()) {
+            size_t n = builder.write_some(fds[1]);
+            saw_full_pipe = saw_full_pipe || n == 0;
+            written += n;
+            CHECK(builder.remaining_bytes() == total - written);
+            if (n == 0) {
+                drain(fds[0], received);
+            }
+        }
+        drain(fds[0], received);
+        CHECK(saw_full_pipe);
+        CHECK(builder.write_some(fds[1]) == 0);
+
+        Vector<uint8_t> expected;
+        for (size_t i = 0; i < header.size(); ++i) {
+            expected.push_back(header.data()[i]);
+        }
+        for (size_t i = 0; i < big.size(); ++i) {
+            expected.push_back(big[i]);
+        }
+        const uint8_t* word_bytes = reinterpret_cast<const uint8_t*>(words.data());
+        for (size_t i = 0; i < words.size() * 4; ++i) {
+            expected.push_back(word_bytes[i]);
+        }
+        expected.push_back('e');
+        expected.push_back('n');
+        expected.push_back('d');
+        CHECK(received == expected);
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    // More entries than one writev accepts go out over several calls.
+    {
+        int fds[2];
+        CHECK(::pipe(fds) == 0);
+        size_t entries = detail::iov_max() + 10;
+        Vector<uint8_t> bytes = pattern(entries, 3);
+        IoVecBuilder builder;
+        for (size_t i = 0; i < entries; ++i) {
+            builder.add(bytes.data() + i, 1);
+        }
+        CHECK(builder.count() == entries);
+        CHECK(builder.write_all(fds[1]) == entries);
+        ::close(fds[1]);
+        Vector<uint8_t> received;
+        drain(fds[0], received);
+        CHECK(received == bytes);
+        ::close(fds[0]);
+        builder.clear();
+        CHECK(builder.done() && builder.count() == 0);
+    }
+
+    // Scatter read: targets fill in order, keep only what arrived and keep their old contents;
+    // targets past IOV_MAX wait for the next call; EOF reads 0 and leaves targets unchanged.
+    {
+        int fds[2];
+        CHECK(::pipe(fds) == 0);
+        Vector<uint8_t> payload = pattern(100, 9);
+        CHECK(::write(fds[1], payload.data(), payload.size()) == 100);
+        ::close(fds[1]);
+
+        Vector<uint8_t> first(2, 0xAA);
+        Vector<char> second;
+        ByteBuffer third;
+        third.put_u8(0xBB);
+        IoVecReader reader;
+        reader.add(first, 30);
+        reader.add(second, 50);
+        reader.add(third, 40);
+        CHECK(reader.read_from(fds[0]) == 100);
+        CHECK(reader.count() == 0);
+        CHECK(first.size() == 32 && first[0] == 0xAA && first[2] == payload[0] && first[31] == payload[29]);
+        CHECK(second.size() == 50 && static_cast<uint8_t>(second[49]) == payload[79]);
+        CHECK(third.size() == 21 && third.data()[0] == 0xBB && third.data()[20] == payload[99]);
+
+        Vector<uint8_t> after_eof;
+        CHECK(read_into(fds[0], after_eof, 16) == 0);
+        CHECK(after_eof.empty());
+        ::close(fds[0]);
+    }
+    {
+        int fds[2];
+        CHECK(::pipe(fds) == 0);
+        size_t targets = detail::iov_max() + 3;
+        Vector<uint8_t> payload = pattern(targets, 5);
+        CHECK(::write(fds[1], payload.data(), payload.size()) == static_cast<ssize_t>(targets));
+        Vector<Vector<uint8_t>> outputs(targets);
+        IoVecReader reader;
+        for (size_t i = 0; i < targets; ++i) {
+            reader.add(outputs[i], 1);
+        }
+        CHECK(reader.read_from(fds[0]) == detail::iov_max());
+        CHECK(reader.count() == 3);
+        CHECK(reader.read_from(fds[0]) == 3);
+        bool filled = true;
+        for (size_t i = 0; i < targets; ++i) {
+            filled = filled && outputs[i].size() == 1 && outputs[i][0] == payload[i];
+        }
+        CHECK(filled);
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    // A non-blocking descriptor with nothing ready reads 0 and restores the targets.
+    {
+        int fds[2];
+        CHECK(::pipe(fds) == 0);
+        ::fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        Vector<uint8_t> target(3, 1);
+        CHECK(read_into(fds[0], target, 64) == 0);
+        CHECK(target.size() == 3);
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    // Errors other than would-block throw; read targets are restored first.
+    {
+        Vector<uint8_t> target(5, 1);
+        CHECK_THROWS(read_into(-1, target, 64), std::system_error);
+        CHECK(target.size() == 5);
+        IoVecBuilder builder;
+        builder.add(target);
+        CHECK_THROWS(builder.write_some(-1), std::system_error);
+        CHECK(builder.remaining_bytes() == 5);
+    }
+
+    return test::result();
+}
+
+#else
+
+int main() { return 0; }
+
+#endif
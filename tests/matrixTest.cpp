@@ -0,0 +1,115 @@
+#include "../matrix.hpp"
+#include "check.hpp"
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+bool line_aligned(const void* p) { return reinterpret_cast<std::uintptr_t>(p) % kCacheLineSize == 0; }
+
+template <typename T>
+void check_alignment(size_t rows, size_t cols, Layout layout) {
+    Matrix<T> m(rows, cols, layout);
+    size_t outer = layout == Layout::RowMajor ? rows : cols;
+    for (size_t k = 0; k < outer; ++k) {
+        const T& first = layout == Layout::RowMajor ? m(k, 0) : m(0, k);
+        CHECK(line_aligned(&first));
+    }
+    CHECK(m.leading_dimension() % (kCacheLineSize / sizeof(T)) == 0);
+}
+
+template <typename T>
+void check_transpose(size_t rows, size_t cols, Layout layout) {
+    Matrix<T> m(rows, cols, layout);
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) {
+            m(i, j) = static_cast<T>(i * 1000 + j);
+        }
+    }
+    Matrix<T> t = m.transposed();
+    CHECK(t.rows() == cols && t.cols() == rows);
+    bool same = true;
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) {
+            same = same && t(j, i) == m(i, j);
+        }
+    }
+    CHECK(same);
+}
+
+} // namespace
+
+int main() {
+    // Every row (or column) starts on a cache line, including when the inner extent is already a
+    // whole number of lines and needs no padding.
+    for (size_t rows : {1, 3, 4, 7}) {
+        for (size_t cols : {1, 5, 15, 16, 17, 32, 33, 64}) {
+            check_alignment<float>(rows, cols, Layout::RowMajor);
+            check_alignment<double>(rows, cols, Layout::ColMajor);
+            check_alignment<char>(rows, cols, Layout::RowMajor);
+            check_alignment<uint16_t>(rows, cols, Layout::ColMajor);
+        }
+    }
+    CHECK(padded_leading_dimension<float>(16) == 16);
+    CHECK(padded_leading_dimension<float>(17) == 32);
+    CHECK(padded_leading_dimension<double>(0) == 0);
+
+    // Fill value, element access and bounds.
+    Matrix<int> m(3, 4, 7);
+    CHECK(m.rows() == 3 && m.cols() == 4);
+    CHECK(m(2, 3) == 7);
+    m.at(1, 2) = 5;
+    CHECK(m(1, 2) == 5);
+    CHECK_THROWS(m.at(3, 0), std::out_of_range);
+    CHECK_THROWS(m.at(0, 4), std::out_of_range);
+    Matrix<int> empty;
+    CHECK(empty.rows() == 0 && empty.view().empty());
+    Matrix<int> no_rows(0, 5);
+    CHECK(no_rows.view().size() == 0);
+
+    // Copies are deep and keep the layout.
+    Matrix<int> duplicate = m;
+    duplicate(0, 0) = 99;
+    CHECK(m(0, 0) == 7 && duplicate(1, 2) == 5);
+    Matrix<int> moved = std::move(duplicate);
+    CHECK(moved(0, 0) == 99 && line_aligned(&moved(0, 0)));
+
+    // Blocked transpose across block-size boundaries, in both layouts.
+    for (size_t rows : {1, 2, 31, 32, 33, 100}) {
+        for (size_t cols : {1, 17, 64, 65}) {
+            check_transpose<float>(rows, cols, Layout::RowMajor);
+            check_transpose<double>(rows, cols, Layout::ColMajor);
+        }
+    }
+
+    // Views: slices, steps, subviews and contiguity.
+    int raw[24];
+    for (int i = 0; i < 24; ++i) {
+        raw[i] = i;
+    }
+    TensorView<int, 3> cube(raw, {2, 3, 4}, {12, 4, 1});
+    CHECK(cube.is_contiguous() && cube.size() == 24);
+    CHECK(cube(1, 2, 3) == 23);
+    CHECK_THROWS(cube.at(2, 0, 0), std::out_of_range);
+    TensorView<int, 3> every_other = cube.slice(2, 0, 4, 2);
+    CHECK(every_other.extent(2) == 2 && every_other(1, 1, 1) == 18);
+    CHECK(!every_other.is_contiguous());
+    CHECK_THROWS(cube.slice(3, 0, 1), std::out_of_range);
+    CHECK_THROWS(cube.slice(0, 1, 3), std::out_of_range);
+    CHECK_THROWS(cube.slice(0, 0, 1, 0), std::out_of_range);
+    TensorView<int, 2> plane = cube.subview(0, 1);
+    CHECK(plane.extent(0) == 3 && plane(2, 3) == 23);
+    CHECK_THROWS(cube.subview(0, 2), std::out_of_range);
+    TensorView<int, 3> swapped = cube.transposed(0, 2);
+    CHECK(swapped.extent(0) == 4 && swapped(3, 2, 1) == cube(1, 2, 3));
+    CHECK_THROWS(cube.transposed(0, 3), std::out_of_range);
+    CHECK_THROWS(cube.transposed(5, 1), std::out_of_range);
+    CHECK(cube.transposed(1, 1).strides() == cube.strides());
+
+    MatrixView<int> block = m.block(1, 1, 2, 2);
+    CHECK(block(0, 1) == 5);
+    Matrix<int> small(2, 3);
+    CHECK_THROWS(copy(m.view(), small.view()), std::invalid_argument);
+
+    return test::result();
+}
@@ -0,0 +1,114 @@
+#include "../parseNumbers.hpp"
+#include "check.hpp"
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+template <typename T>
+bool parses(std::string_view text) {
+    Vector<T> out;
+    try {
+        parse_numbers(text, out);
+    } catch (const std::invalid_argument&) {
+        return false;
+    }
+    return true;
+}
+
+template <typename T>
+Vector<T> parse(std::string_view text, char delim = ',') {
+    Vector<T> out;
+    parse_numbers(text, out, delim);
+    return out;
+}
+
+} // namespace
+
+int main() {
+    // Separators, blanks and empty fields.
+    CHECK(parse<int>("").empty());
+    CHECK(parse<int>(",,\n\r\n ,\t").empty());
+    CHECK((parse<int>("1,2,3") == Vector<int>{1, 2, 3}));
+    CHECK((parse<int>(" 1 ,\t2\r\n3,\n") == Vector<int>{1, 2, 3}));
+    CHECK((parse<int>("4;5\n6", ';') == Vector<int>{4, 5, 6}));
+    CHECK((parse<long long>("-9223372036854775808,+7") == Vector<long long>{INT64_MIN, 7}));
+    CHECK((parse<double>("1.5,-2e3,+0.25,inf") == Vector<double>{1.5, -2000.0, 0.25, std::numeric_limits<double>::infinity()}));
+
+    // A field of 40+ characters, spanning more than one SIMD separator scan.
+    std::string wide(70, ' ');
+    wide += "12";
+    wide += std::string(70, ' ');
+    CHECK((parse<int>(wide) == Vector<int>{12}));
+
+    // Appends to what is already there.
+    Vector<int> out{9};
+    CHECK(parse_numbers(std::string_view("1,2"), out) == 2);
+    CHECK((out == Vector<int>{9, 1, 2}));
+
+    // Anything that is not exactly one number is rejected.
+    CHECK(!parses<int>("1,x,3"));
+    CHECK(!parses<int>("1 2"));
+    CHECK(!parses<int>("1.5"));
+    CHECK(!parses<int>("+"));
+    CHECK(!parses<int>("+-5"));
+    CHECK(!parses<int>("++5"));
+    CHECK(!parses<double>("+-1.5"));
+    CHECK(!parses<int>("-+5"));
+    CHECK(!parses<uint8_t>("256"));
+    CHECK(!parses<uint32_t>("-1"));
+    CHECK(!parses<int>("0x10"));
+
+    // The error names the field and its offset.
+    try {
+        parse<int>("10,20,abc,40");
+        CHECK(false);
+    } catch (const std::invalid_argument& e) {
+        CHECK(std::string(e.what()).find("offset 6") != std::string::npos);
+        CHECK(std::string(e.what()).find("'abc'") != std::string::npos);
+    }
+
+    // A failed parse leaves out as it was, from either parser.
+    {
+        Vector<int> kept{9};
+        CHECK_THROWS(parse_numbers(std::string_view("1,2,x"), kept), std::invalid_argument);
+        CHECK((kept == Vector<int>{9}));
+    }
+
+    // The parallel parser matches the serial one, including on chunk cuts inside blank runs.
+    std::string big;
+    Vector<int64_t> expected;
+    for (int64_t i = 0; i < 400000; ++i) {
+        int64_t v = (i * 7919) % 100003 - 50000;
+        big += std::to_string(v);
+        big += (i % 10 == 0) ? "\n\n" : ",";
+        expected.push_back(v);
+    }
+    for (size_t threads : {1, 2, 3, 8}) {
+        Vector<int64_t> parallel;
+        CHECK(parse_numbers_parallel(std::string_view(big), parallel, ',', threads) == expected.size());
+        CHECK(parallel == expected);
+    }
+
+    // Error offsets from the parallel parser are positions in the whole input, not in a chunk.
+    std::string bad = big;
+    size_t bad_at = bad.size() * 3 / 4;
+    while (bad[bad_at] == ',' || bad[bad_at] == '\n' || bad[bad_at - 1] != ',') {
+        ++bad_at;
+    }
+    bad.insert(bad_at, "x");
+    try {
+        Vector<int64_t> parallel;
+        parse_numbers_parallel(std::string_view(bad), parallel, ',', 4);
+        CHECK(false);
+    } catch (const std::invalid_argument& e) {
+        CHECK(std::string(e.what()).find("offset " + std::to_string(bad_at) + ":") != std::string::npos);
+    }
+    Vector<int64_t> untouched{1, 2};
+    CHECK_THROWS(parse_numbers_parallel(std::string_view(bad), untouched, ',', 4), std::invalid_argument);
+    CHECK((untouched == Vector<int64_t>{1, 2}));
+
+    return test::result();
+}
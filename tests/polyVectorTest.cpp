@@ -0,0 +1,104 @@
+#include "../polyVector.hpp"
+#include "check.hpp"
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace {
+
+struct Shape {
+    virtual ~Shape() = default;
+    virtual int area() const = 0;
+};
+
+struct Square final : Shape {
+    int side;
+    explicit Square(int s) : side(s) {}
+    int area() const override { return side * side; }
+};
+
+struct Rect : Shape {
+    int w;
+    int h;
+    std::string name;
+    Rect(int w_, int h_, std::string n) : w(w_), h(h_), name(std::move(n)) {}
+    int area() const override { return w * h; }
+};
+
+// Base reached through a virtual base and a second base class, so it is not at offset zero.
+struct Tag {
+    virtual ~Tag() = default;
+    int tag = 7;
+};
+
+struct Odd : Tag, virtual Shape {
+    int value;
+    explicit Odd(int v) : value(v) {}
+    int area() const override { return value; }
+};
+
+} // namespace
+
+int main() {
+    PolyVector<Shape> shapes;
+    CHECK(shapes.empty() && shapes.segment_count() == 0);
+    PolyVector<Shape>::Handle s1 = shapes.emplace<Square>(2);
+    PolyVector<Shape>::Handle r1 = shapes.emplace<Rect>(2, 3, "r1");
+    PolyVector<Shape>::Handle o1 = shapes.emplace<Odd>(5);
+    PolyVector<Shape>::Handle s2 = shapes.push_back(Square(3));
+    CHECK(shapes.size() == 4 && shapes.segment_count() == 3);
+    CHECK(shapes.size<Square>() == 2 && shapes.size<Rect>() == 1 && shapes.size<Odd>() == 1);
+    CHECK(shapes.at(s1).area() == 4 && shapes.get(o1)->area() == 5 && shapes.at(s2).area() == 9);
+    CHECK(shapes.get_as<Rect>(r1)->name == "r1" && shapes.get_as<Square>(r1) == nullptr);
+    CHECK(shapes.get_as<Odd>(o1)->tag == 7);
+
+    // Many elements per segment, then erase from the middle: handles to the survivors still
+    // resolve, including the element moved into the hole.
+    Vector<PolyVector<Shape>::Handle> handles;
+    for (int i = 0; i < 1000; ++i) {
+        handles.push_back(i % 2 ? shapes.emplace<Square>(i) : shapes.emplace<Odd>(i));
+    }
+    int total = 0;
+    shapes.for_each([&](const Shape& s) { total += s.area(); });
+    int expected = 4 + 6 + 5 + 9;
+    for (int i = 0; i < 1000; ++i) {
+        expected += i % 2 ? i * i : i;
+    }
+    CHECK(total == expected);
+    CHECK(shapes.erase(handles[1]) && !shapes.erase(handles[1]));
+    CHECK(!shapes.contains(handles[1]) && shapes.get(handles[1]) == nullptr);
+    CHECK_THROWS(shapes.at(handles[1]), std::out_of_range);
+    bool resolved = true;
+    for (int i = 2; i < 1000; ++i) {
+        resolved = resolved && shapes.at(handles[static_cast<size_t>(i)]).area() == (i % 2 ? i * i : i);
+    }
+    CHECK(resolved);
+    CHECK(shapes.size() == 1003);
+
+    // A reused slot gets a new generation, so the old handle stays stale.
+    PolyVector<Shape>::Handle reused = shapes.emplace<Square>(100);
+    CHECK(reused.slot == handles[1].slot && !(reused == handles[1]));
+    CHECK(shapes.get(handles[1]) == nullptr && shapes.at(reused).area() == 10000);
+
+    // Typed iteration passes listed types as D& and the rest as Base&.
+    int typed_squares = 0;
+    int untyped = 0;
+    shapes.for_each<Square>([&](auto& s) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(s)>, Square>) {
+            ++typed_squares;
+        } else {
+            ++untyped;
+        }
+    });
+    CHECK(typed_squares == static_cast<int>(shapes.size<Square>()));
+    CHECK(typed_squares + untyped == static_cast<int>(shapes.size()));
+
+    // Moves keep handles valid; clear() invalidates every handle.
+    PolyVector<Shape> moved = std::move(shapes);
+    CHECK(moved.at(r1).area() == 6);
+    moved.clear();
+    CHECK(moved.empty() && !moved.contains(r1) && moved.get(s1) == nullptr);
+    CHECK(moved.get(PolyVector<Shape>::Handle{}) == nullptr);
+
+    return test::result();
+}
@@ -0,0 +1,85 @@
+#include "../prefetchTraversal.hpp"
+#include "check.hpp"
+#include <stdexcept>
+
+namespace {
+
+struct Node {
+    uint64_t key;
+    char payload[200]; // spans several cache lines
+};
+
+} // namespace
+
+int main() {
+    Vector<Node> nodes(100);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        nodes[i].key = i * 10;
+    }
+
+    // Every distance, including 0, one larger than the input and one far larger, visits every
+    // element exactly once and in order.
+    Vector<uint32_t> order;
+    for (uint32_t i = 0; i < 100; ++i) {
+        order.push_back((i * 37) % 100);
+    }
+    Vector<Node*> pointers;
+    for (uint32_t id : order) {
+        pointers.push_back(&nodes[id]);
+    }
+    bool in_order = true;
+    for (size_t distance : {size_t(0), size_t(1), size_t(8), size_t(99), size_t(100), size_t(101), size_t(-1)}) {
+        size_t seen = 0;
+        for_each_prefetched(pointers, [&](Node* p) { in_order = in_order && p == pointers[seen++]; }, distance);
+        in_order = in_order && seen == pointers.size();
+
+        seen = 0;
+        for_each_prefetched(order, nodes, [&](Node& n) { in_order = in_order && n.key == order[seen++] * 10; }, distance);
+        in_order = in_order && seen == order.size();
+
+        Vector<uint64_t> keys = transform_indirect(order, static_cast<const Vector<Node>&>(nodes),
+                                                   [](const Node& n) { return n.key; }, distance);
+        Vector<uint64_t> via_pointers = transform_indirect(pointers, [](Node* p) { return p->key; }, distance);
+        in_order = in_order && keys == via_pointers && keys.size() == 100 && keys[1] == 370;
+    }
+    CHECK(in_order);
+
+    // The mutable overload hands out writable elements.
+    Vector<int> small_ids;
+    small_ids.push_back(3);
+    small_ids.push_back(3);
+    for_each_prefetched(small_ids, nodes, [](Node& n) { n.key += 1; });
+    CHECK(nodes[3].key == 32);
+
+    // Empty inputs visit nothing; null pointers are passed through to f untouched.
+    Vector<Node*> none;
+    size_t calls = 0;
+    for_each_prefetched(none, [&](Node*) { ++calls; });
+    CHECK(calls == 0);
+    Vector<Node*> with_nulls(20, nullptr);
+    with_nulls[7] = &nodes[5];
+    Vector<uint64_t> keys = transform_indirect(with_nulls, [](Node* p) { return p == nullptr ? uint64_t(0) : p->key; });
+    CHECK(keys.size() == 20 && keys[7] == 50 && keys[8] == 0);
+
+    // An out-of-range or negative index throws when it is reached, after the earlier elements
+    // have been visited; prefetching it beforehand is harmless.
+    Vector<int64_t> bad;
+    for (int64_t i = 0; i < 12; ++i) {
+        bad.push_back(i);
+    }
+    bad[10] = 100;
+    size_t visited = 0;
+    CHECK_THROWS(for_each_prefetched(bad, nodes, [&](Node&) { ++visited; }), std::out_of_range);
+    CHECK(visited == 10);
+    bad[10] = -1;
+    visited = 0;
+    const Vector<Node>& const_nodes = nodes;
+    CHECK_THROWS(for_each_prefetched(bad, const_nodes, [&](const Node&) { ++visited; }, 2), std::out_of_range);
+    CHECK(visited == 10);
+    Vector<uint32_t> past_end(1, 100);
+    CHECK_THROWS(transform_indirect(past_end, const_nodes, [](const Node& n) { return n.key; }), std::out_of_range);
+    Vector<Node> empty_base;
+    CHECK_THROWS(for_each_prefetched(past_end, empty_base, [](Node&) {}), std::out_of_range);
+
+    return test::result();
+}
@@ -0,0 +1,172 @@
+#include "../reducedPrecision.hpp"
+#include "check.hpp"
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+bool near(double a, double b, double tolerance) { return std::fabs(a - b) <= tolerance * (1.0 + std::fabs(b)); }
+
+template <typename Packed>
+void check_packed_batches(const Vector<float>& values, double tolerance) {
+    // Batch encode/decode must agree with the scalar codec element by element, at every length
+    // around the SIMD widths.
+    for (size_t n : {0, 1, 7, 8, 9, 15, 16, 17, 33, 1000}) {
+        Vector<float> head;
+        for (size_t i = 0; i < n; ++i) {
+            head.push_back(values[i]);
+        }
+        Packed packed(head);
+        CHECK(packed.size() == n);
+        Vector<float> decoded = packed.to_vector();
+        bool same = decoded.size() == n;
+        double sum = 0.0;
+        double dot = 0.0;
+        for (size_t i = 0; i < n && same; ++i) {
+            Packed one;
+            one.push_back(head[i]);
+            same = packed.raw()[i] == one.raw()[0] && decoded[i] == packed[i];
+            sum += decoded[i];
+            dot += static_cast<double>(decoded[i]) * head[i];
+        }
+        CHECK(same);
+        CHECK(near(packed.sum(), sum, 1e-4));
+        CHECK(near(packed.dot(head), dot, 1e-4));
+        CHECK(near(packed.dot(packed), dot, tolerance));
+    }
+}
+
+} // namespace
+
+int main() {
+    const float inf = std::numeric_limits<float>::infinity();
+
+    // fp16: exact values, rounding to nearest even, overflow, subnormals and NaN.
+    CHECK(HalfCodec::encode(1.0f) == 0x3C00);
+    CHECK(HalfCodec::encode(-2.0f) == 0xC000);
+    CHECK(HalfCodec::encode(65504.0f) == 0x7BFF);
+    CHECK(HalfCodec::encode(65536.0f) == 0x7C00);
+    CHECK(HalfCodec::encode(-inf) == 0xFC00);
+    CHECK(HalfCodec::encode(1.0f + 1.0f / 2048) == 0x3C00);
+    CHECK(HalfCodec::encode(1.0f + 3.0f / 2048) == 0x3C02);
+    CHECK(HalfCodec::decode(0x0001) == std::ldexp(1.0f, -24));
+    CHECK(HalfCodec::encode(std::ldexp(1.0f, -24)) == 0x0001);
+    CHECK(HalfCodec::encode(std::ldexp(1.0f, -26)) == 0x0000);
+    CHECK(std::isnan(HalfCodec::decode(HalfCodec::encode(std::nanf("")))));
+    CHECK(std::isinf(HalfCodec::decode(0x7C00)));
+
+    // bf16: truncation with round to nearest even, and NaN stays NaN instead of rounding to inf.
+    CHECK(BFloat16Codec::encode(1.0f) == 0x3F80);
+    CHECK(BFloat16Codec::decode(BFloat16Codec::encode(3.0f)) == 3.0f);
+    CHECK(BFloat16Codec::encode(detail::bits_float(0x3F808000u)) == 0x3F80);
+    CHECK(BFloat16Codec::encode(detail::bits_float(0x3F818000u)) == 0x3F82);
+    CHECK(std::isnan(BFloat16Codec::decode(BFloat16Codec::encode(detail::bits_float(0x7F800001u)))));
+    CHECK(BFloat16Codec::encode(inf) == 0x7F80);
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> uniform(-4.0f, 4.0f);
+    Vector<float> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(uniform(rng));
+    }
+    check_packed_batches<HalfVector>(values, 1e-2);
+    check_packed_batches<BFloat16Vector>(values, 1e-1);
+
+    HalfVector half(values);
+    CHECK_THROWS(half.at(values.size()), std::out_of_range);
+    CHECK_THROWS(half.dot(HalfVector()), std::invalid_argument);
+    half.set(3, 0.5f);
+    CHECK(half[3] == 0.5f);
+
+    // Quantized: per-block error bound, constant blocks, and a partial last block.
+    QuantizedVector<> q(values);
+    CHECK(q.size() == values.size());
+    CHECK(q.block_count() == values.size() / 32);
+    float max_error = 0.0f;
+    for (size_t i = 0; i < values.size(); ++i) {
+        max_error = std::max(max_error, std::fabs(q[i] - values[i]));
+    }
+    CHECK(max_error <= 8.0f / 255 / 2 + 1e-5f);
+    for (size_t i = q.block_count() * 32; i < values.size(); ++i) {
+        CHECK(q[i] == values[i]);
+    }
+    Vector<float> flat(70, 1.25f);
+    QuantizedVector<> constant(flat);
+    CHECK(constant[0] == 1.25f && constant[69] == 1.25f && constant.sum() == 1.25f * 70);
+    CHECK_THROWS(q.at(values.size()), std::out_of_range);
+    CHECK_THROWS(q.dot(QuantizedVector<>()), std::invalid_argument);
+    CHECK(QuantizedVector<>().empty() && QuantizedVector<>().sum() == 0.0f);
+
+    // Non-finite values do not spoil their block: infinities take the ends of its finite range
+    // and NaN the code nearest zero. Ranges wider than FLT_MAX still get a finite scale.
+    {
+        const float inf = std::numeric_limits<float>::infinity();
+        Vector<float> odd(32);
+        for (size_t i = 0; i < odd.size(); ++i) {
+            odd[i] = static_cast<float>(i) - 10.0f;
+        }
+        odd[3] = inf;
+        odd[4] = -inf;
+        odd[5] = std::numeric_limits<float>::quiet_NaN();
+        QuantizedVector<> coded(odd);
+        CHECK(std::isfinite(coded.scale(0)) && std::isfinite(coded.zero_point(0)));
+        CHECK(near(coded[3], 21.0, 0.01) && near(coded[4], -10.0, 0.01) && near(coded[5], 0.0, 0.1));
+        CHECK(near(coded[20], 10.0, 0.01));
+        Vector<float> all_odd(32, inf);
+        all_odd[1] = std::numeric_limits<float>::quiet_NaN();
+        QuantizedVector<uint8_t> none_finite(all_odd);
+        CHECK(none_finite.scale(0) == 0.0f && none_finite[0] == 0.0f && none_finite[1] == 0.0f);
+        const float big = std::numeric_limits<float>::max();
+        Vector<float> extreme(32, 0.0f);
+        extreme[0] = -big;
+        extreme[1] = big;
+        QuantizedVector<uint8_t> wide_range(extreme);
+        QuantizedVector<> wide_signed(extreme);
+        CHECK(std::isfinite(wide_range.scale(0)) && std::isfinite(wide_signed.scale(0)));
+        CHECK(wide_range.codes()[0] == 0 && wide_range.codes()[1] == 255);
+        CHECK(wide_signed.codes()[0] == -128 && wide_signed.codes()[1] == 127);
+    }
+
+    // Appending one value at a time gives exactly what assign() does: the unfinished block is
+    // held as floats and quantized once, when it fills.
+    QuantizedVector<> pushed;
+    for (size_t i = 0; i < values.size(); ++i) {
+        pushed.push_back(values[i]);
+    }
+    QuantizedVector<> appended;
+    for (size_t i = 0; i < values.size(); i += 7) {
+        appended.append(values.data() + i, std::min<size_t>(7, values.size() - i));
+    }
+    bool same = pushed.size() == q.size() && appended.size() == q.size();
+    for (size_t i = 0; i < values.size() && same; ++i) {
+        same = pushed[i] == q[i] && appended[i] == q[i];
+    }
+    CHECK(same);
+
+    // sum() and both dot() overloads against the dequantized values.
+    Vector<float> decoded = q.to_vector();
+    double sum = 0.0;
+    double dot = 0.0;
+    double mixed = 0.0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        sum += decoded[i];
+        dot += static_cast<double>(decoded[i]) * pushed[i];
+        mixed += static_cast<double>(decoded[i]) * values[i];
+    }
+    CHECK(near(q.sum(), sum, 1e-4));
+    CHECK(near(q.dot(pushed), dot, 1e-4));
+    CHECK(near(q.dot(values), mixed, 1e-4));
+
+    QuantizedVector<int16_t, 16> wide(values);
+    float wide_error = 0.0f;
+    for (size_t i = 0; i < values.size(); ++i) {
+        wide_error = std::max(wide_error, std::fabs(wide[i] - values[i]));
+    }
+    CHECK(wide_error < 1e-3f);
+    wide.clear();
+    CHECK(wide.empty() && wide.block_count() == 0);
+
+    return test::result();
+}
@@ -0,0 +1,69 @@
+#include "../stringPool.hpp"
+#include "check.hpp"
+#include "failingAllocation.hpp"
+#include <new>
+#include <stdexcept>
+#include <string>
+
+int main() {
+    StringPool pool;
+    CHECK(pool.empty() && pool.find("a") == StringPool::kNotFound);
+
+    // Ids are dense and in first-seen order; the empty string is a string like any other.
+    CHECK(pool.intern("apple") == 0);
+    CHECK(pool.intern("") == 1);
+    CHECK(pool.intern("pear") == 2);
+    CHECK(pool.intern("apple") == 0);
+    CHECK(pool.intern("") == 1);
+    CHECK(pool.size() == 3 && pool.arena_bytes() == 9);
+    CHECK(pool.view(0) == "apple" && pool[1].empty() && pool.at(2) == "pear");
+    CHECK(pool.find("pear") == 2 && !pool.contains("plum"));
+    CHECK_THROWS(pool.at(3), std::out_of_range);
+
+    // Many strings across several rehashes, then the batch path over a mix of old and new ones.
+    for (int i = 0; i < 20000; ++i) {
+        CHECK(pool.intern("key" + std::to_string(i)) == static_cast<uint32_t>(i + 3));
+    }
+    Vector<std::string> storage;
+    for (int i = 19990; i < 20100; ++i) {
+        storage.push_back("key" + std::to_string(i));
+    }
+    Vector<std::string_view> batch;
+    for (size_t i = 0; i < storage.size(); ++i) {
+        batch.push_back(storage[i]);
+    }
+    Vector<uint32_t> ids = pool.intern_batch(batch);
+    bool consistent = ids.size() == batch.size();
+    for (size_t i = 0; i < batch.size() && consistent; ++i) {
+        consistent = ids[i] == static_cast<uint32_t>(19990 + i + 3) && pool.view(ids[i]) == batch[i];
+    }
+    CHECK(consistent);
+
+    // A failed table allocation during rehash leaves the index intact: no lost strings and no
+    // duplicate ids afterwards.
+    StringPool small;
+    for (int i = 0; i < 8; ++i) {
+        small.intern("s" + std::to_string(i));
+    }
+    std::string ninth = "s8";
+    test::allocations_until_failure = 0;
+    CHECK_THROWS(small.intern(ninth), std::bad_alloc);
+    test::allocations_until_failure = -1;
+    CHECK(small.size() == 8);
+    for (int i = 0; i < 8; ++i) {
+        CHECK(small.intern("s" + std::to_string(i)) == static_cast<uint32_t>(i));
+    }
+    CHECK(small.intern(ninth) == 8 && small.size() == 9);
+
+    // Frozen pools answer lookups and reject new strings and clear().
+    small.freeze();
+    CHECK(small.frozen() && small.intern("s3") == 3 && small.find("s8") == 8);
+    CHECK_THROWS(small.intern("new"), std::logic_error);
+    CHECK_THROWS(small.clear(), std::logic_error);
+
+    pool.clear();
+    CHECK(pool.empty() && pool.find("apple") == StringPool::kNotFound);
+    CHECK(pool.intern("pear") == 0);
+
+    return test::result();
+}
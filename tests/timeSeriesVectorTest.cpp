@@ -0,0 +1,170 @@
+#include "../timeSeriesVector.hpp"
+#include "check.hpp"
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+using Series = TimeSeriesVector<int32_t>;
+
+struct Sample {
+    int64_t time;
+    int32_t value;
+};
+
+Series::Aggregate brute_force(const Vector<Sample>& samples, int64_t from, int64_t to) {
+    Series::Aggregate out;
+    for (const Sample& s : samples) {
+        if (s.time >= from && s.time < to) {
+            out.add(s.value);
+        }
+    }
+    return out;
+}
+
+bool same(const Series::Aggregate& a, const Series::Aggregate& b) {
+    return a.count == b.count && a.sum == b.sum && (a.count == 0 || (a.min == b.min && a.max == b.max));
+}
+
+} // namespace
+
+int main() {
+    CHECK_THROWS(Series(0), std::invalid_argument);
+    CHECK_THROWS(Series(-5), std::invalid_argument);
+    CHECK_THROWS(Series(std::numeric_limits<int64_t>::max() / 1000), std::invalid_argument);
+
+    // Ten ticks per second keeps minute (600) and hour (36000) buckets small enough that random
+    // ranges cross every level. Timestamps start negative, repeat and leave gaps.
+    Series series(10);
+    CHECK(series.bucket_width(Rollup::Second) == 10 && series.bucket_width(Rollup::Hour) == 36000);
+    std::mt19937_64 rng(11);
+    Vector<Sample> samples;
+    int64_t t = -50000;
+    for (int i = 0; i < 20000; ++i) {
+        uint64_t step = rng() % 100;
+        t += step < 60 ? 0 : step < 95 ? static_cast<int64_t>(rng() % 20) : static_cast<int64_t>(rng() % 5000);
+        int32_t value = static_cast<int32_t>(rng() % 2001) - 1000;
+        series.append(t, value);
+        samples.push_back({t, value});
+    }
+    CHECK(series.size() == samples.size() && series.chunk_count() == 5);
+    CHECK(series.first_time() == samples[0].time && series.last_time() == samples.back().time);
+    CHECK_THROWS(series.append(series.last_time() - 1, 0), std::invalid_argument);
+    CHECK(series.size() == samples.size());
+
+    bool aggregates_match = true;
+    const int64_t lo = samples[0].time - 1000;
+    const int64_t span = samples.back().time - lo + 2000;
+    for (int q = 0; q < 2000; ++q) {
+        int64_t a = lo + static_cast<int64_t>(rng() % static_cast<uint64_t>(span));
+        int64_t b = lo + static_cast<int64_t>(rng() % static_cast<uint64_t>(span));
+        int64_t from = std::min(a, b);
+        int64_t to = std::max(a, b) + static_cast<int64_t>(q % 3);
+        aggregates_match = aggregates_match && same(series.aggregate(from, to), brute_force(samples, from, to));
+    }
+    CHECK(aggregates_match);
+
+    // Whole-series and unbounded queries, empty and inverted ranges.
+    int64_t min_time = std::numeric_limits<int64_t>::min();
+    int64_t max_time = std::numeric_limits<int64_t>::max();
+    Series::Aggregate all = series.aggregate(min_time, max_time);
+    CHECK(same(all, brute_force(samples, min_time, max_time)) && all.count == samples.size());
+    CHECK(series.aggregate(5, 5).count == 0 && series.aggregate(10, 5).count == 0);
+    CHECK(std::isnan(series.aggregate(10, 5).mean()));
+    CHECK(series.aggregate(max_time - 1, max_time).count == 0);
+
+    // Timestamps at the ends of the int64 range: too early for a representable hour bucket is
+    // rejected, and queries near INT64_MAX do not overflow while aligning to buckets.
+    {
+        Series edge(1000);
+        CHECK_THROWS(edge.append(min_time + 5, 1), std::invalid_argument);
+        CHECK(edge.empty());
+        int64_t hour = edge.bucket_width(Rollup::Hour);
+        int64_t earliest = min_time - min_time % hour;
+        edge.append(earliest, 1);
+        edge.append(earliest + 1, 2);
+        CHECK(edge.rollup(Rollup::Hour).size() == 1 && edge.rollup(Rollup::Hour)[0].start == earliest);
+        CHECK(edge.aggregate(min_time, max_time).count == 2);
+        edge.append(max_time - 1, 3);
+        edge.append(max_time, 4);
+        CHECK(edge.aggregate(min_time, max_time).count == 3);
+        Series::Aggregate top = edge.aggregate(max_time - 1, max_time);
+        CHECK(top.count == 1 && top.sum == 3);
+        CHECK(edge.downsample(max_time - 1, max_time, Rollup::Hour).size() == 1);
+    }
+
+    // Samples sharing one timestamp across a chunk boundary are all found.
+    {
+        Series flat(1000);
+        for (size_t i = 0; i < Series::kChunkSamples + 10; ++i) {
+            flat.append(7, 1);
+        }
+        flat.append(8, 1);
+        CHECK(flat.chunk_count() == 2);
+        CHECK(flat.aggregate(7, 8).count == Series::kChunkSamples + 10);
+        size_t visited = 0;
+        flat.for_each_sample(7, 8, [&](int64_t, int32_t) { ++visited; });
+        CHECK(visited == Series::kChunkSamples + 10);
+    }
+
+    // for_each_sample yields the raw samples of a range in order.
+    {
+        int64_t from = samples[5000].time;
+        int64_t to = samples[9000].time;
+        size_t index = 0;
+        while (samples[index].time < from) {
+            ++index;
+        }
+        bool in_order = true;
+        series.for_each_sample(from, to, [&](int64_t time, int32_t value) {
+            in_order = in_order && samples[index].time == time && samples[index].value == value;
+            ++index;
+        });
+        CHECK(in_order && (index == samples.size() || samples[index].time >= to));
+    }
+
+    // Rollups hold the non-empty aligned buckets in order, and downsample returns the ones that
+    // overlap the range.
+    {
+        const Vector<Series::Bucket>& minutes = series.rollup(Rollup::Minute);
+        bool aligned = true;
+        uint64_t counted = 0;
+        for (size_t i = 0; i < minutes.size(); ++i) {
+            const Series::Bucket& bucket = minutes[i];
+            aligned = aligned && bucket.start % 600 == 0 && bucket.value.count > 0;
+            aligned = aligned && (i == 0 || minutes[i - 1].start < bucket.start);
+            aligned = aligned && same(bucket.value, brute_force(samples, bucket.start, bucket.start + 600));
+            counted += bucket.value.count;
+        }
+        CHECK(aligned && counted == samples.size());
+
+        int64_t from = samples[100].time + 1;
+        int64_t to = samples[3000].time;
+        Vector<Series::Bucket> chart = series.downsample(from, to, Rollup::Minute);
+        size_t expected = 0;
+        bool covers = !chart.empty();
+        for (size_t i = 0; i < minutes.size(); ++i) {
+            if (minutes[i].start + 600 > from && minutes[i].start < to) {
+                covers = covers && expected < chart.size() && chart[expected].start == minutes[i].start;
+                ++expected;
+            }
+        }
+        CHECK(covers && chart.size() == expected);
+        CHECK(series.downsample(to, from, Rollup::Hour).empty());
+    }
+
+    // Floating-point values accumulate in double; clear() empties everything.
+    {
+        TimeSeriesVector<float> floats;
+        floats.append(0, 1.5f);
+        floats.append(1, -2.5f);
+        TimeSeriesVector<float>::Aggregate agg = floats.aggregate(0, 2);
+        CHECK(agg.count == 2 && agg.sum == -1.0 && agg.min == -2.5f && agg.max == 1.5f && agg.mean() == -0.5);
+        floats.clear();
+        CHECK(floats.empty() && floats.aggregate(min_time, max_time).count == 0 && floats.rollup(Rollup::Second).empty());
+        floats.append(-3, 4.0f);
+        CHECK(floats.size() == 1 && floats.first_time() == -3);
+    }
+
+    return test::result();
+}
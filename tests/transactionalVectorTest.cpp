@@ -0,0 +1,128 @@
+#include "../transactionalVector.hpp"
+#include "check.hpp"
+#include "failingAllocation.hpp"
+#include <new>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+bool copies_throw = false;
+
+struct Fragile {
+    int value = 0;
+    Fragile(int v = 0) : value(v) {}
+    Fragile(const Fragile& other) : value(other.value) {
+        if (copies_throw) {
+            throw std::runtime_error("copy");
+        }
+    }
+    Fragile& operator=(const Fragile&) = default;
+    bool operator==(const Fragile& other) const { return value == other.value; }
+};
+
+Vector<int> iota(int n) {
+    Vector<int> out;
+    for (int i = 0; i < n; ++i) {
+        out.push_back(i);
+    }
+    return out;
+}
+
+} // namespace
+
+int main() {
+    // Outside a transaction nothing is logged.
+    TransactionalVector<int> tv(iota(5));
+    tv.set(0, 10);
+    tv.push_back(5);
+    CHECK(tv.undo_log_size() == 0 && tv[0] == 10 && tv.size() == 6);
+    CHECK_THROWS(tv.commit(), std::logic_error);
+    CHECK_THROWS(tv.rollback(), std::logic_error);
+    CHECK_THROWS(tv.set(6, 1), std::out_of_range);
+
+    // Every kind of mutation rolls back to the exact contents at begin().
+    Vector<int> before = tv.values();
+    tv.begin();
+    tv.set(1, 100);
+    tv.mutable_at(2) = 200;
+    tv.push_back(7);
+    tv.pop_back();
+    tv.pop_back();
+    tv.resize(10, -1);
+    tv.resize(3);
+    tv.set(0, 0);
+    tv.clear();
+    tv.push_back(42);
+    CHECK(tv.size() == 1 && tv.in_transaction());
+    tv.rollback();
+    CHECK(tv.values() == before && !tv.in_transaction() && tv.undo_log_size() == 0);
+
+    // Nested transactions: an inner rollback undoes only its own changes, an inner commit folds
+    // into the outer transaction, and the outer commit drops the log.
+    tv.begin();
+    tv.set(0, 1);
+    tv.begin();
+    tv.set(1, 2);
+    tv.push_back(3);
+    CHECK(tv.depth() == 2);
+    tv.rollback();
+    CHECK(tv[0] == 1 && tv[1] == before[1] && tv.size() == before.size());
+    tv.begin();
+    tv.set(2, 9);
+    tv.commit();
+    CHECK(tv.depth() == 1 && tv.undo_log_size() > 0);
+    tv.rollback();
+    CHECK(tv.values() == before);
+    tv.begin();
+    tv.set(2, 9);
+    tv.commit();
+    CHECK(tv[2] == 9 && tv.undo_log_size() == 0);
+
+    // Non-trivial elements.
+    TransactionalVector<std::string> strings;
+    strings.push_back("a");
+    strings.begin();
+    strings.set(0, std::string(100, 'x'));
+    strings.push_back("b");
+    strings.clear();
+    strings.rollback();
+    CHECK(strings.size() == 1 && strings[0] == "a");
+
+    // A throwing copy of the old value logs nothing and leaves the slot unchanged.
+    TransactionalVector<Fragile> fragile;
+    fragile.push_back(Fragile(1));
+    fragile.push_back(Fragile(2));
+    fragile.begin();
+    fragile.set(0, Fragile(5));
+    copies_throw = true;
+    CHECK_THROWS(fragile.set(1, Fragile(6)), std::runtime_error);
+    copies_throw = false;
+    CHECK(fragile[1].value == 2);
+    fragile.rollback();
+    CHECK(fragile[0].value == 1 && fragile[1].value == 2);
+
+    // An allocation failure while growing either log keeps the two logs in step, so writes after
+    // it still roll back to the right slots.
+    for (long failing = 0; failing < 2; ++failing) {
+        TransactionalVector<int> logged(iota(64));
+        logged.begin();
+        size_t writes = 0;
+        bool failed = false;
+        for (size_t i = 0; i < 64; ++i) {
+            test::allocations_until_failure = (failed || i < 10) ? -1 : failing;
+            try {
+                logged.set(i, -static_cast<int>(i) - 1);
+                ++writes;
+            } catch (const std::bad_alloc&) {
+                failed = true;
+            }
+            test::allocations_until_failure = -1;
+        }
+        CHECK(failed && logged.undo_log_size() == writes);
+        logged.rollback();
+        CHECK(logged.values() == iota(64));
+    }
+
+    return test::result();
+}
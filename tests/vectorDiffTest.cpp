@@ -0,0 +1,175 @@
+#include "../vectorDiff.hpp"
+#include "check.hpp"
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+template <typename T>
+void check_round_trip(const Vector<T>& old_vec, const Vector<T>& new_vec) {
+    Patch<T> patch = diff(old_vec, new_vec);
+    Vector<uint8_t> wire = patch.serialize();
+    Patch<T> decoded = Patch<T>::deserialize(wire.data(), wire.size());
+    Vector<T> out = old_vec;
+    apply(out, decoded, true);
+    CHECK(out == new_vec);
+}
+
+void header(uint64_t old_size, uint64_t new_size, uint64_t op_count, uint64_t literal_count, ByteBuffer& out) {
+    out.put_u32(Patch<uint32_t>::kMagic);
+    out.put_u8(sizeof(uint32_t));
+    out.put_varint(old_size);
+    out.put_varint(new_size);
+    out.put_u64(0);
+    out.put_varint(op_count);
+    out.put_varint(literal_count);
+}
+
+Vector<uint8_t> copy_patch(uint64_t old_size, uint64_t new_size, uint64_t gap, uint64_t len, int64_t delta) {
+    ByteBuffer out(64);
+    header(old_size, new_size, 1, 0, out);
+    out.put_u8(static_cast<uint8_t>(PatchOpKind::Copy));
+    out.put_varint(gap);
+    out.put_varint(len);
+    out.put_svarint(delta);
+    return out.take();
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(7);
+
+    // Empty, identical, grown, shrunk and fully rewritten vectors.
+    Vector<uint32_t> empty;
+    Vector<uint32_t> base;
+    for (uint32_t i = 0; i < 5000; ++i) {
+        base.push_back(static_cast<uint32_t>(rng()));
+    }
+    check_round_trip(empty, empty);
+    check_round_trip(empty, base);
+    check_round_trip(base, empty);
+    check_round_trip(base, base);
+    CHECK(diff(base, base).empty());
+
+    // In-place edits, an insertion and a deletion that shift the rest of the data.
+    Vector<uint32_t> edited = base;
+    edited[10] = 1;
+    edited[4000] = 2;
+    check_round_trip(base, edited);
+    Vector<uint32_t> inserted;
+    for (size_t i = 0; i < base.size(); ++i) {
+        if (i == 1000) {
+            for (uint32_t k = 0; k < 37; ++k) {
+                inserted.push_back(k);
+            }
+        }
+        inserted.push_back(base[i]);
+    }
+    check_round_trip(base, inserted);
+    check_round_trip(inserted, base);
+    Vector<uint32_t> rewritten;
+    for (size_t i = 0; i < base.size(); ++i) {
+        rewritten.push_back(~base[i]);
+    }
+    check_round_trip(base, rewritten);
+
+    // Byte elements and random splices.
+    for (int round = 0; round < 50; ++round) {
+        Vector<uint8_t> a;
+        size_t n = rng() % 3000;
+        for (size_t i = 0; i < n; ++i) {
+            a.push_back(static_cast<uint8_t>(rng() % 4));
+        }
+        Vector<uint8_t> b;
+        for (size_t i = 0; i < n; ++i) {
+            if (rng() % 500 == 0) {
+                continue;
+            }
+            if (rng() % 700 == 0) {
+                b.push_back(static_cast<uint8_t>(rng()));
+            }
+            b.push_back(a[i]);
+        }
+        check_round_trip(a, b);
+    }
+
+    // apply() checks the base before touching it.
+    Patch<uint32_t> patch = diff(base, edited);
+    Vector<uint32_t> wrong_size = empty;
+    CHECK_THROWS(apply(wrong_size, patch), std::invalid_argument);
+    Vector<uint32_t> wrong_content = rewritten;
+    CHECK_THROWS(apply(wrong_content, patch, true), std::invalid_argument);
+    CHECK(wrong_content == rewritten);
+
+    // Every truncation of a valid patch is rejected.
+    Vector<uint8_t> wire = diff(base, inserted).serialize();
+    for (size_t cut = 0; cut < wire.size(); ++cut) {
+        CHECK_THROWS(Patch<uint32_t>::deserialize(wire.data(), cut), std::exception);
+    }
+    Vector<uint8_t> bad_magic = wire;
+    bad_magic[0] ^= 1;
+    CHECK_THROWS(Patch<uint32_t>::deserialize(bad_magic.data(), bad_magic.size()), std::invalid_argument);
+    CHECK_THROWS(Patch<uint64_t>::deserialize(wire.data(), wire.size()), std::invalid_argument);
+
+    // Lengths and offsets chosen so that the unchecked sums would wrap.
+    const uint64_t kMax = UINT64_MAX;
+    Vector<uint8_t> wrap_len = copy_patch(100, 100, 10, kMax, 0);
+    CHECK_THROWS(Patch<uint32_t>::deserialize(wrap_len.data(), wrap_len.size()), std::invalid_argument);
+    Vector<uint8_t> wrap_gap = copy_patch(100, 100, kMax, 20, 0);
+    CHECK_THROWS(Patch<uint32_t>::deserialize(wrap_gap.data(), wrap_gap.size()), std::invalid_argument);
+    Vector<uint8_t> wrap_src = copy_patch(100, 100, 10, 20, INT64_MIN);
+    CHECK_THROWS(Patch<uint32_t>::deserialize(wrap_src.data(), wrap_src.size()), std::invalid_argument);
+    Vector<uint8_t> wrap_src_up = copy_patch(kMax, kMax, kMax - 5, 1, INT64_MAX);
+    CHECK_THROWS(Patch<uint32_t>::deserialize(wrap_src_up.data(), wrap_src_up.size()), std::invalid_argument);
+    Vector<uint8_t> in_range = copy_patch(100, 100, 10, 20, 30);
+    CHECK(Patch<uint32_t>::deserialize(in_range.data(), in_range.size()).ops.size() == 1);
+
+    // A literal op longer than the declared literal section, whose length would wrap the cursor.
+    {
+        ByteBuffer out(64);
+        header(0, 10, 2, 1, out);
+        out.put_u8(static_cast<uint8_t>(PatchOpKind::Literal));
+        out.put_varint(0);
+        out.put_varint(1);
+        out.put_u8(static_cast<uint8_t>(PatchOpKind::Literal));
+        out.put_varint(0);
+        out.put_varint(kMax);
+        out.put_u32(0);
+        Vector<uint8_t> bytes = out.take();
+        CHECK_THROWS(Patch<uint32_t>::deserialize(bytes.data(), bytes.size()), std::invalid_argument);
+    }
+
+    // Periodic data hashes every old block into one chain; an insertion at the front must not
+    // make matching walk all of it for every position.
+    {
+        Vector<uint32_t> periodic;
+        for (uint32_t i = 0; i < 400000; ++i) {
+            periodic.push_back(i % 16);
+        }
+        Vector<uint32_t> shifted;
+        shifted.push_back(99);
+        for (uint32_t x : periodic) {
+            shifted.push_back(x);
+        }
+        Patch<uint32_t> patch = diff(periodic, shifted);
+        CHECK(patch.ops.size() <= 4);
+        check_round_trip(periodic, shifted);
+        check_round_trip(shifted, periodic);
+    }
+
+    // Counts that the remaining input could not hold are rejected before anything is reserved.
+    {
+        ByteBuffer out(64);
+        header(0, 0, kMax / 2, 0, out);
+        Vector<uint8_t> bytes = out.take();
+        CHECK_THROWS(Patch<uint32_t>::deserialize(bytes.data(), bytes.size()), std::invalid_argument);
+        ByteBuffer lits(64);
+        header(0, 0, 0, kMax / 2, lits);
+        Vector<uint8_t> lit_bytes = lits.take();
+        CHECK_THROWS(Patch<uint32_t>::deserialize(lit_bytes.data(), lit_bytes.size()), std::invalid_argument);
+    }
+
+    return test::result();
+}
@@ -0,0 +1,107 @@
+#include "../vectorHash.hpp"
+#include "check.hpp"
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+
+int main() {
+    // Streaming in any split, including splits that land on and around stripe boundaries, gives
+    // the one-shot value; lengths cover the empty input, partial tails and whole stripes.
+    unsigned char bytes[300];
+    for (size_t i = 0; i < sizeof(bytes); ++i) {
+        bytes[i] = static_cast<unsigned char>(i * 131 + 7);
+    }
+    bool streaming_matches = true;
+    for (size_t n : {size_t(0), size_t(1), size_t(8), size_t(16), size_t(17), size_t(47), size_t(48),
+                     size_t(49), size_t(96), size_t(97), size_t(300)}) {
+        uint64_t expected = hash_bytes(bytes, n, 5);
+        for (size_t split = 0; split <= n; ++split) {
+            Hasher hasher(5);
+            hasher.update(bytes, split);
+            hasher.update(bytes + split, n - split);
+            streaming_matches = streaming_matches && hasher.finish() == expected;
+        }
+        Hasher bytewise(5);
+        for (size_t i = 0; i < n; ++i) {
+            bytewise.update(bytes + i, 1);
+        }
+        streaming_matches = streaming_matches && bytewise.finish() == expected;
+    }
+    CHECK(streaming_matches);
+
+    // finish() does not consume state.
+    Hasher partial;
+    partial.update(bytes, 60);
+    uint64_t first = partial.finish();
+    CHECK(partial.finish() == first);
+    partial.update(bytes + 60, 40);
+    CHECK(partial.finish() == hash_bytes(bytes, 100));
+
+    // The seed, the length (zero padding is not ambiguous) and every input bit affect the value.
+    CHECK(hash_bytes(bytes, 64, 1) != hash_bytes(bytes, 64, 2));
+    unsigned char zeros[10] = {};
+    CHECK(hash_bytes(zeros, 0) != hash_bytes(zeros, 1));
+    CHECK(hash_bytes(zeros, 9) != hash_bytes(zeros, 10));
+    std::unordered_set<uint64_t> flipped;
+    unsigned char copy[100];
+    for (size_t bit = 0; bit < 100 * 8; ++bit) {
+        std::memcpy(copy, bytes, sizeof(copy));
+        copy[bit / 8] ^= static_cast<unsigned char>(1u << (bit % 8));
+        flipped.insert(hash_bytes(copy, sizeof(copy)));
+    }
+    flipped.insert(hash_bytes(bytes, 100));
+    CHECK(flipped.size() == 100 * 8 + 1);
+
+    // Bytewise types hash their storage; equal contents hash equal whatever the capacity.
+    Vector<uint32_t> a;
+    Vector<uint32_t> b;
+    b.reserve(1000);
+    for (uint32_t i = 0; i < 100; ++i) {
+        a.push_back(i);
+        b.push_back(i);
+    }
+    CHECK(hash(a) == hash(b));
+    CHECK(hash(a) == hash_bytes(a.data(), a.size() * sizeof(uint32_t)));
+    CHECK(std::hash<Vector<uint32_t>>()(a) == static_cast<size_t>(hash(a)));
+    b[50] = 1000;
+    CHECK(hash(a) != hash(b));
+    CHECK(hash(Vector<uint32_t>()) == hash_bytes(nullptr, 0));
+
+    // Other types go through std::hash per element: floats that compare equal hash equal.
+    static_assert(!is_bytewise_hashable_v<float>);
+    static_assert(!is_bytewise_hashable_v<std::string>);
+    Vector<float> positive(3, 0.0f);
+    Vector<float> negative(3, -0.0f);
+    CHECK(hash(positive) == hash(negative));
+    Vector<std::string> words;
+    words.push_back("alpha");
+    words.push_back("beta");
+    Vector<std::string> swapped;
+    swapped.push_back("beta");
+    swapped.push_back("alpha");
+    CHECK(hash(words) != hash(swapped));
+
+    // IncrementalHash tracks hash() of an append-only Vector and rejects shrinking.
+    Vector<uint64_t> log;
+    IncrementalHash<uint64_t> incremental(9);
+    incremental.update(log);
+    CHECK(incremental.value() == hash(log, 9));
+    bool incremental_matches = true;
+    for (uint64_t i = 0; i < 50; ++i) {
+        for (uint64_t j = 0; j <= i % 4; ++j) {
+            log.push_back(i * 31 + j);
+        }
+        incremental.update(log);
+        incremental_matches = incremental_matches && incremental.value() == hash(log, 9) &&
+                              incremental.consumed() == log.size();
+    }
+    CHECK(incremental_matches);
+    log.pop_back();
+    CHECK_THROWS(incremental.update(log), std::logic_error);
+
+    IncrementalHash<std::string> text_hash;
+    text_hash.update(words);
+    CHECK(text_hash.value() == hash(words));
+
+    return test::result();
+}
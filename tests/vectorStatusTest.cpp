@@ -0,0 +1,123 @@
+#include "../customVector.hpp"
+#include "check.hpp"
+#include <string>
+
+// The try_* members must work without exceptions, so this program avoids CHECK_THROWS and
+// failing operator new: build it with -fno-exceptions as well as in the default mode.
+
+namespace {
+
+// Fails allocate_nothrow() once the countdown reaches zero; -1 never fails.
+template <typename T>
+struct CountdownAllocator {
+    using value_type = T;
+
+    static inline long allocations_until_failure = -1;
+
+    CountdownAllocator() = default;
+    template <typename U> CountdownAllocator(const CountdownAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T))); }
+    T* allocate_nothrow(size_t n) noexcept {
+        if (allocations_until_failure >= 0 && allocations_until_failure-- == 0) {
+            return nullptr;
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T), std::nothrow));
+    }
+    void deallocate(T* ptr, size_t) { ::operator delete(ptr); }
+
+    friend bool operator==(const CountdownAllocator&, const CountdownAllocator&) { return true; }
+    friend bool operator!=(const CountdownAllocator&, const CountdownAllocator&) { return false; }
+};
+
+template <typename T>
+using CountdownVector = Vector<T, CountdownAllocator<T>>;
+
+template <typename T>
+void fail_next_allocation() {
+    CountdownAllocator<T>::allocations_until_failure = 0;
+}
+
+template <typename T>
+void allow_allocations() {
+    CountdownAllocator<T>::allocations_until_failure = -1;
+}
+
+} // namespace
+
+int main() {
+    VectorStatus ok;
+    CHECK(ok.ok() && static_cast<bool>(ok) && ok.error() == VectorErrc::ok);
+    VectorStatus oom(VectorErrc::out_of_memory);
+    CHECK(!oom && oom.error() == VectorErrc::out_of_memory);
+    CHECK(std::string(oom.message()) == "out of memory");
+    CHECK(std::string(VectorStatus(VectorErrc::length_error).message()) == "requested size exceeds max_size()");
+
+    // Sizes beyond max_size() are refused before any allocation is attempted.
+    {
+        Vector<uint64_t> v(3, 9);
+        VectorStatus status = v.try_reserve(v.max_size() + 1);
+        CHECK(status.error() == VectorErrc::length_error);
+        CHECK(v.size() == 3 && v.capacity() == 3 && v[2] == 9);
+        CHECK(v.try_resize(v.max_size() + 1, 1).error() == VectorErrc::length_error);
+        CHECK(v.size() == 3);
+    }
+
+    // A failed growth leaves size, capacity, storage and contents untouched, and the Vector keeps
+    // working once memory is available again.
+    {
+        CountdownVector<std::string> v;
+        bool all_ok = true;
+        for (int i = 0; i < 10; ++i) {
+            all_ok = all_ok && v.try_push_back(std::to_string(i)).ok();
+        }
+        CHECK(all_ok);
+        while (v.size() < v.capacity()) {
+            all_ok = all_ok && v.try_emplace_back(3, 'x').ok();
+        }
+        CHECK(all_ok);
+        size_t size = v.size();
+        size_t capacity = v.capacity();
+        const std::string* storage = v.data();
+
+        fail_next_allocation<std::string>();
+        std::string moved_from = "kept";
+        CHECK(v.try_push_back(std::move(moved_from)).error() == VectorErrc::out_of_memory);
+        CHECK(moved_from == "kept");
+        CHECK(v.size() == size && v.capacity() == capacity && v.data() == storage);
+        CHECK(v[0] == "0" && v[9] == "9" && v.back() == "xxx");
+
+        fail_next_allocation<std::string>();
+        CHECK(v.try_emplace_back("y").error() == VectorErrc::out_of_memory);
+        fail_next_allocation<std::string>();
+        CHECK(v.try_reserve(capacity * 4).error() == VectorErrc::out_of_memory);
+        fail_next_allocation<std::string>();
+        CHECK(v.try_resize(capacity + 1).error() == VectorErrc::out_of_memory);
+        fail_next_allocation<std::string>();
+        CHECK(v.try_resize(capacity + 1, "z").error() == VectorErrc::out_of_memory);
+        CHECK(v.size() == size && v.capacity() == capacity && v.data() == storage);
+
+        // Requests that need no allocation succeed even while allocation is failing.
+        fail_next_allocation<std::string>();
+        CHECK(v.try_reserve(capacity).ok());
+        CHECK(v.try_resize(5).ok() && v.size() == 5 && v[4] == "4");
+        CHECK(v.try_resize(capacity, "w").ok() && v.back() == "w");
+        CHECK(v.data() == storage);
+
+        allow_allocations<std::string>();
+        CHECK(v.try_push_back("after").ok());
+        CHECK(v.size() == capacity + 1 && v.capacity() > capacity && v.back() == "after" && v[0] == "0");
+        CHECK(v.try_resize(100, "r").ok() && v.size() == 100 && v[99] == "r");
+    }
+
+    // Allocators without allocate_nothrow still work through the try_* members.
+    {
+        Vector<int> v;
+        CHECK(v.try_reserve(0).ok() && v.capacity() == 0);
+        CHECK(v.try_resize(4, 2).ok() && v.size() == 4 && v[3] == 2);
+        Vector<int, AlignedAllocator<int, 64>> aligned;
+        CHECK(aligned.try_resize(33).ok() && reinterpret_cast<uintptr_t>(aligned.data()) % 64 == 0);
+    }
+
+    return test::result();
+}
@@ -0,0 +1,135 @@
+#include "../versionedVector.hpp"
+#include "check.hpp"
+#include "failingAllocation.hpp"
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+int main() {
+    // Snapshots keep seeing the state they pinned; chunks cover a partial last chunk.
+    VersionedVector<int> vv(10, 0, 4, 4);
+    CHECK(vv.size() == 10 && vv.chunk_count() == 3 && vv.version_count() == 3);
+    auto before = vv.snapshot();
+    uint64_t ts = vv.set(9, 90);
+    CHECK(ts == before.timestamp() + 1 && vv.latest_timestamp() == ts);
+    auto after = vv.snapshot();
+    CHECK(before[9] == 0 && after[9] == 90 && after.chunk_size(2) == 2);
+    CHECK(vv.version_count() == 4);
+
+    // A batch publishes all its writes under one timestamp, and only on commit.
+    {
+        auto batch = vv.write();
+        batch.set(0, 1);
+        batch.set(5, 5);
+        batch.mutable_at(5) += 50;
+        CHECK_THROWS(batch.set(10, 0), std::out_of_range);
+        // Reading the count from inside a batch must not take the writer lock again.
+        CHECK(vv.version_count() == 4);
+        CHECK(vv.snapshot()[0] == 0);
+        uint64_t committed = batch.commit();
+        CHECK(committed == ts + 1);
+    }
+    auto batched = vv.snapshot();
+    CHECK(batched[0] == 1 && batched[5] == 55 && batched[9] == 90);
+    CHECK(vv.version_count() == 6);
+
+    // A batch dropped without commit() leaves no trace.
+    {
+        auto batch = vv.write();
+        batch.set(1, 11);
+    }
+    CHECK(vv.snapshot()[1] == 0 && vv.version_count() == 6);
+
+    // Collection keeps what pinned snapshots can see and frees the rest once they are released.
+    CHECK(vv.collect_garbage() == 0);
+    Vector<int> old_contents;
+    before.copy_to(old_contents);
+    CHECK(old_contents.size() == 10 && old_contents[9] == 0 && old_contents[0] == 0);
+    {
+        auto released = std::move(before);
+        auto also_released = std::move(after);
+    }
+    CHECK(vv.collect_garbage() == 3);
+    CHECK(vv.version_count() == 3 && batched[9] == 90);
+
+    // Snapshot slots are limited.
+    auto a = vv.snapshot();
+    auto b = vv.snapshot();
+    auto c = vv.snapshot();
+    CHECK_THROWS(vv.snapshot(), std::runtime_error);
+
+    // Constructed from values; readers and a background collector run against a writer.
+    Vector<int> initial;
+    for (int i = 0; i < 256; ++i) {
+        initial.push_back(0);
+    }
+    VersionedVector<int> shared(initial, 16, 8);
+    shared.start_background_gc(std::chrono::milliseconds(1));
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    Vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                auto snap = shared.snapshot();
+                int first = snap[0];
+                for (size_t i = 1; i < snap.size(); ++i) {
+                    if (snap[i] != first) {
+                        torn.fetch_add(1);
+                        break;
+                    }
+                }
+            }
+        });
+    }
+    for (int round = 1; round <= 300; ++round) {
+        auto batch = shared.write();
+        for (size_t i = 0; i < shared.size(); ++i) {
+            batch.set(i, round);
+        }
+        batch.commit();
+    }
+    done.store(true);
+    for (size_t r = 0; r < readers.size(); ++r) {
+        readers[r].join();
+    }
+    shared.stop_background_gc();
+    CHECK(torn.load() == 0);
+    shared.collect_garbage();
+    CHECK(shared.version_count() == shared.chunk_count());
+    CHECK(shared.snapshot()[255] == 300);
+
+    // A batch whose allocations fail part-way leaves nothing pending behind: a later batch over
+    // the same chunks publishes every write. Each round starts from a fresh vector so the
+    // failures also land on the first growth of the batch's own bookkeeping.
+    {
+        bool consistent = true;
+        for (long failing = 0; failing < 200; ++failing) {
+            VersionedVector<int> chunks(40, 0, 1);
+            try {
+                auto batch = chunks.write();
+                test::allocations_until_failure = failing;
+                for (size_t i = 0; i < chunks.size(); ++i) {
+                    batch.set(i, -1);
+                }
+                test::allocations_until_failure = -1;
+            } catch (const std::bad_alloc&) {
+                test::allocations_until_failure = -1;
+            }
+            auto batch = chunks.write();
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                batch.set(i, static_cast<int>(failing));
+            }
+            batch.commit();
+            auto view = chunks.snapshot();
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                consistent = consistent && view[i] == static_cast<int>(failing);
+            }
+        }
+        CHECK(consistent);
+    }
+
+    return test::result();
+}
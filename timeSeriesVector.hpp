@@ -0,0 +1,237 @@
+#pragma once
+
+#include "customVector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+enum class Rollup : int { Second = 0, Minute = 1, Hour = 2 };
+
+// An append-only series of (timestamp, value) samples with min/max/sum/count rollups kept up to
+// date at 1 s, 1 min and 1 h resolution. Raw samples live in fixed-size chunks of separate time
+// and value columns, so appends never move existing data. Each rollup level is a Vector of the
+// non-empty buckets in time order, aligned to multiples of the bucket width.
+//
+// aggregate(from, to) answers from the coarsest level that fits: whole hours come from the hour
+// buckets, the partial hours at either end from minute buckets, and so on down to raw samples
+// only for the sub-second edges. An hours-long query therefore reads a few dozen buckets rather
+// than every sample.
+//
+// Timestamps are integer ticks (nanoseconds unless the constructor says otherwise) and must not
+// decrease from one append to the next. A timestamp so close to INT64_MIN that the start of its
+// hour bucket is not representable is rejected.
+template <typename T>
+class TimeSeriesVector {
+    static_assert(std::is_arithmetic_v<T>, "TimeSeriesVector values must be arithmetic");
+
+public:
+    using Sum = std::conditional_t<std::is_floating_point_v<T>, double, std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+    struct Aggregate {
+        T min = std::numeric_limits<T>::max();
+        T max = std::numeric_limits<T>::lowest();
+        Sum sum = 0;
+        uint64_t count = 0;
+
+        void add(T value) {
+            min = std::min(min, value);
+            max = std::max(max, value);
+            sum += static_cast<Sum>(value);
+            ++count;
+        }
+
+        void merge(const Aggregate& other) {
+            min = std::min(min, other.min);
+            max = std::max(max, other.max);
+            sum += other.sum;
+            count += other.count;
+        }
+
+        double mean() const { return count == 0 ? std::nan("") : static_cast<double>(sum) / static_cast<double>(count); }
+    };
+
+    struct Bucket {
+        int64_t start;
+        Aggregate value;
+    };
+
+    static constexpr size_t kChunkSamples = 4096;
+    static constexpr int kLevels = 3;
+
+    explicit TimeSeriesVector(int64_t ticks_per_second = 1000000000) {
+        if (ticks_per_second <= 0) {
+            VECTOR_THROW(std::invalid_argument("TimeSeriesVector ticks_per_second must be positive"));
+        }
+        if (ticks_per_second > std::numeric_limits<int64_t>::max() / 3600) {
+            VECTOR_THROW(std::invalid_argument("TimeSeriesVector ticks_per_second is too large for hour buckets"));
+        }
+        widths_[0] = ticks_per_second;
+        widths_[1] = ticks_per_second * 60;
+        widths_[2] = ticks_per_second * 3600;
+        // The first multiple of the hour width; INT64_MIN % width is in (-width, 0].
+        min_time_ = std::numeric_limits<int64_t>::min() - std::numeric_limits<int64_t>::min() % widths_[2];
+    }
+
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    size_t chunk_count() const noexcept { return chunks_.size(); }
+    int64_t first_time() const { return chunks_.front().times.front(); }
+    int64_t last_time() const { return chunks_.back().times.back(); }
+
+    int64_t bucket_width(Rollup level) const noexcept { return widths_[static_cast<int>(level)]; }
+    const Vector<Bucket>& rollup(Rollup level) const noexcept { return levels_[static_cast<int>(level)]; }
+
+    void append(int64_t time, T value) {
+        if (size_ != 0 && time < last_time()) {
+            VECTOR_THROW(std::invalid_argument("TimeSeriesVector timestamps must not decrease"));
+        }
+        if (time < min_time_) {
+            VECTOR_THROW(std::invalid_argument("TimeSeriesVector timestamp is before the first representable hour bucket"));
+        }
+        if (chunks_.empty() || chunks_.back().times.size() == kChunkSamples) {
+            chunks_.emplace_back();
+            chunks_.back().times.reserve(kChunkSamples);
+            chunks_.back().values.reserve(kChunkSamples);
+            chunk_first_.push_back(time);
+        }
+        Chunk& chunk = chunks_.back();
+        chunk.times.push_back(time);
+        chunk.values.push_back(value);
+        ++size_;
+        for (int level = 0; level < kLevels; ++level) {
+            int64_t start = align_down(time, widths_[level]);
+            Vector<Bucket>& buckets = levels_[level];
+            if (buckets.empty() || buckets.back().start != start) {
+                buckets.push_back(Bucket{start, Aggregate{}});
+            }
+            buckets.back().value.add(value);
+        }
+    }
+
+    void append_batch(const int64_t* times, const T* values, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            append(times[i], values[i]);
+        }
+    }
+
+    // Calls f(time, value) for every raw sample with from <= time < to, in order.
+    template <typename F>
+    void for_each_sample(int64_t from, int64_t to, F&& f) const {
+        if (size_ == 0 || from >= to) {
+            return;
+        }
+        // Start in the last chunk that begins before from: with repeated timestamps, samples at
+        // exactly from can end one chunk and begin the next.
+        const int64_t* firsts = chunk_first_.data();
+        size_t c = static_cast<size_t>(std::lower_bound(firsts, firsts + chunk_first_.size(), from) - firsts);
+        c = c == 0 ? 0 : c - 1;
+        for (; c < chunks_.size(); ++c) {
+            const Chunk& chunk = chunks_[c];
+            const int64_t* times = chunk.times.data();
+            size_t n = chunk.times.size();
+            size_t i = static_cast<size_t>(std::lower_bound(times, times + n, from) - times);
+            for (; i < n; ++i) {
+                if (times[i] >= to) {
+                    return;
+                }
+                f(times[i], chunk.values[i]);
+            }
+        }
+    }
+
+    // min/max/sum/count over from <= time < to, read from the coarsest rollups that cover the
+    // range and from raw samples only at sub-second edges.
+    Aggregate aggregate(int64_t from, int64_t to) const {
+        Aggregate out;
+        if (size_ == 0) {
+            return out;
+        }
+        // Clamped to the stored span, every bucket start that collect() aligns to is at or after
+        // that of the first sample, which append() checked to be representable.
+        from = std::max(from, first_time());
+        if (last_time() < std::numeric_limits<int64_t>::max()) {
+            to = std::min(to, last_time() + 1);
+        }
+        collect(kLevels - 1, from, to, out);
+        return out;
+    }
+
+    // The buckets of one rollup level that overlap [from, to), e.g. one point per minute for a
+    // chart. Edge buckets are whole, so they may include samples just outside the range.
+    Vector<Bucket> downsample(int64_t from, int64_t to, Rollup level) const {
+        Vector<Bucket> out;
+        if (size_ == 0 || from >= to) {
+            return out;
+        }
+        const Vector<Bucket>& buckets = levels_[static_cast<int>(level)];
+        int64_t start = align_down(std::max(from, first_time()), widths_[static_cast<int>(level)]);
+        for (size_t i = lower_bucket(buckets, start); i < buckets.size() && buckets[i].start < to; ++i) {
+            out.push_back(buckets[i]);
+        }
+        return out;
+    }
+
+    void clear() {
+        chunks_.clear();
+        chunk_first_.clear();
+        for (int level = 0; level < kLevels; ++level) {
+            levels_[level].clear();
+        }
+        size_ = 0;
+    }
+
+private:
+    struct Chunk {
+        Vector<int64_t> times;
+        Vector<T> values;
+    };
+
+    Vector<Chunk> chunks_;
+    Vector<int64_t> chunk_first_;
+    Vector<Bucket> levels_[kLevels];
+    int64_t widths_[kLevels];
+    int64_t min_time_;
+    size_t size_ = 0;
+
+    // Callers keep t >= min_time_, so the result is representable.
+    static int64_t align_down(int64_t t, int64_t width) {
+        int64_t r = t % width;
+        return r < 0 ? t - r - width : t - r;
+    }
+
+    static size_t lower_bucket(const Vector<Bucket>& buckets, int64_t start) {
+        const Bucket* first = buckets.data();
+        return static_cast<size_t>(
+            std::lower_bound(first, first + buckets.size(), start, [](const Bucket& b, int64_t s) { return b.start < s; }) - first);
+    }
+
+    void collect(int level, int64_t from, int64_t to, Aggregate& out) const {
+        if (from >= to) {
+            return;
+        }
+        if (level < 0) {
+            for_each_sample(from, to, [&](int64_t, T value) { out.add(value); });
+            return;
+        }
+        int64_t width = widths_[level];
+        int64_t lo = align_down(from, width);
+        if (lo < from) {
+            // Saturates when the next bucket would start past INT64_MAX, leaving no whole bucket.
+            lo = lo > std::numeric_limits<int64_t>::max() - width ? std::numeric_limits<int64_t>::max() : lo + width;
+        }
+        int64_t hi = align_down(to, width);
+        if (lo >= hi) {
+            collect(level - 1, from, to, out);
+            return;
+        }
+        collect(level - 1, from, lo, out);
+        const Vector<Bucket>& buckets = levels_[level];
+        for (size_t i = lower_bucket(buckets, lo); i < buckets.size() && buckets[i].start < hi; ++i) {
+            out.merge(buckets[i].value);
+        }
+        collect(level - 1, hi, to, out);
+    }
+};
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "customVector.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+// A Vector whose mutations inside a transaction are recorded in an undo log, so rollback()
+// restores the exact contents at begin() without a full copy. The log holds one small record
+// per mutation plus the old value of each overwritten or removed slot; appends only record the
+// previous size. Transactions nest: begin() inside a transaction opens a savepoint that
+// commit() folds into its parent and rollback() undoes on its own.
+//
+// Note that begin() starts a transaction; iterate with data()/size() or values().
+template <typename T, typename Allocator = SimpleAllocator<T>>
+class TransactionalVector {
+public:
+    TransactionalVector() = default;
+    explicit TransactionalVector(Vector<T, Allocator>&& values) : values_(std::move(values)) {}
+
+    size_t size() const noexcept { return values_.size(); }
+    bool empty() const noexcept { return values_.empty(); }
+    const T& operator[](size_t index) const { return values_[index]; }
+    const T* data() const noexcept { return values_.data(); }
+    const Vector<T, Allocator>& values() const noexcept { return values_; }
+
+    bool in_transaction() const noexcept { return !marks_.empty(); }
+    size_t depth() const noexcept { return marks_.size(); }
+    size_t undo_log_size() const noexcept { return records_.size(); }
+
+    void begin() { marks_.push_back(records_.size()); }
+
+    void commit() {
+        require_transaction("commit");
+        marks_.pop_back();
+        if (marks_.empty()) {
+            records_.clear();
+            saved_.clear();
+        }
+    }
+
+    // Replays the inverse of every mutation since the matching begin(), newest first.
+    void rollback() {
+        require_transaction("rollback");
+        size_t mark = marks_.back();
+        marks_.pop_back();
+        while (records_.size() > mark) {
+            Record record = records_.back();
+            records_.pop_back();
+            switch (record.kind) {
+            case Kind::Overwrite:
+                values_[record.index] = std::move(saved_.back());
+                saved_.pop_back();
+                break;
+            case Kind::Remove:
+                values_.push_back(std::move(saved_.back()));
+                saved_.pop_back();
+                break;
+            case Kind::Truncate:
+                truncate(record.index);
+                break;
+            }
+        }
+    }
+
+    void set(size_t index, const T& value) {
+        check_index(index);
+        save_slot(index);
+        values_[index] = value;
+    }
+
+    void set(size_t index, T&& value) {
+        check_index(index);
+        save_slot(index);
+        values_[index] = std::move(value);
+    }
+
+    // Saves the slot's current value before handing out a writable reference.
+    T& mutable_at(size_t index) {
+        check_index(index);
+        save_slot(index);
+        return values_[index];
+    }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        log_size();
+        values_.emplace_back(std::forward<Args>(args)...);
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back() {
+        if (values_.empty()) {
+            return;
+        }
+        if (in_transaction()) {
+            log_saved(Kind::Remove, values_.size() - 1, std::move(values_[values_.size() - 1]));
+        }
+        values_.pop_back();
+    }
+
+    void resize(size_t n) {
+        if (n < values_.size()) {
+            shrink(n);
+        } else if (n > values_.size()) {
+            log_size();
+            values_.resize(n);
+        }
+    }
+
+    void resize(size_t n, const T& value) {
+        if (n < values_.size()) {
+            shrink(n);
+        } else if (n > values_.size()) {
+            log_size();
+            values_.resize(n, value);
+        }
+    }
+
+    void clear() { shrink(0); }
+    void reserve(size_t n) { values_.reserve(n); }
+
+private:
+    enum class Kind : uint8_t { Overwrite, Remove, Truncate };
+
+    // index is the slot for Overwrite/Remove and the size to return to for Truncate.
+    struct Record {
+        Kind kind;
+        size_t index;
+    };
+
+    Vector<T, Allocator> values_;
+    Vector<Record> records_;
+    Vector<T, Allocator> saved_;
+    Vector<size_t> marks_;
+
+    void check_index(size_t index) const {
+        if (index >= values_.size()) {
+            VECTOR_THROW(std::out_of_range("TransactionalVector index out of range"));
+        }
+    }
+
+    void require_transaction(const char* what) const {
+        if (marks_.empty()) {
+            VECTOR_THROW(std::logic_error(std::string("TransactionalVector::") + what + " without begin()"));
+        }
+    }
+
+    void save_slot(size_t index) {
+        if (in_transaction()) {
+            log_saved(Kind::Overwrite, index, values_[index]);
+        }
+    }
+
+    // saved_ and records_ must stay in step. Both are grown first; after that only the copy or
+    // move into saved_ can throw, and it runs before the record is appended.
+    template <typename U>
+    void log_saved(Kind kind, size_t index, U&& value) {
+        reserve_one(records_);
+        reserve_one(saved_);
+        saved_.push_back(std::forward<U>(value));
+        records_.push_back(Record{kind, index});
+    }
+
+    template <typename V>
+    static void reserve_one(V& log) {
+        if (log.size() == log.capacity()) {
+            log.reserve(std::max<size_t>(8, log.capacity() + log.capacity() / 2));
+        }
+    }
+
+    void log_size() {
+        if (in_transaction()) {
+            records_.push_back(Record{Kind::Truncate, values_.size()});
+        }
+    }
+
+    // Removes from the back so each removed value is saved in the order rollback re-appends it.
+    void shrink(size_t n) {
+        if (!in_transaction()) {
+            truncate(n);
+            return;
+        }
+        while (values_.size() > n) {
+            pop_back();
+        }
+    }
+
+    void truncate(size_t n) {
+        while (values_.size() > n) {
+            values_.pop_back();
+        }
+    }
+};
@@ -0,0 +1,382 @@
+#pragma once
+
+#include "customVector.hpp"
+#include "byteBuffer.hpp"
+#include "simd.hpp"
+#include "vectorHash.hpp"
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace detail {
+
+// Baseline kernel: SSE2 is part of x86-64, so it needs no dispatch.
+inline size_t mismatch_bytes_baseline(const uint8_t* a, const uint8_t* b, size_t n) {
+    size_t i = 0;
+#if defined(VECTOR_SIMD_SSE2)
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        uint32_t diff = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y))) & 0xFFFFu;
+        if (diff != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(diff));
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        if (a[i] != b[i]) {
+            return i;
+        }
+    }
+    return n;
+}
+
+#if VECTOR_DISPATCH_X86
+VECTOR_TARGET_AVX2 inline size_t mismatch_bytes_avx2(const uint8_t* a, const uint8_t* b, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        uint32_t diff = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+        if (diff != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(diff));
+        }
+    }
+    return i + mismatch_bytes_baseline(a + i, b + i, n - i);
+}
+
+VECTOR_TARGET_AVX512 inline size_t mismatch_bytes_avx512(const uint8_t* a, const uint8_t* b, size_t n) {
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        uint64_t diff = _mm512_cmpneq_epi8_mask(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+        if (diff != 0) {
+            return i + static_cast<size_t>(__builtin_ctzll(diff));
+        }
+    }
+    if (i < n) {
+        __mmask64 tail = (n - i == 64) ? ~__mmask64(0) : (__mmask64(1) << (n - i)) - 1;
+        uint64_t diff = _mm512_mask_cmpneq_epi8_mask(tail, _mm512_maskz_loadu_epi8(tail, a + i), _mm512_maskz_loadu_epi8(tail, b + i));
+        return diff != 0 ? i + static_cast<size_t>(__builtin_ctzll(diff)) : n;
+    }
+    return n;
+}
+#endif
+
+// Index of the first differing byte of a and b, or n if they are equal.
+inline size_t mismatch_bytes(const uint8_t* a, const uint8_t* b, size_t n) {
+#if VECTOR_DISPATCH_X86
+    static const auto kernel = select_kernel(&mismatch_bytes_baseline, nullptr, &mismatch_bytes_avx2, &mismatch_bytes_avx512);
+    return kernel(a, b, n);
+#else
+    return mismatch_bytes_baseline(a, b, n);
+#endif
+}
+
+// rsync-style weak checksum over a fixed-length byte window; rolls one byte at a time.
+class RollingChecksum {
+public:
+    void reset(const uint8_t* p, size_t len) {
+        a_ = 0;
+        b_ = 0;
+        len_ = static_cast<uint32_t>(len);
+        for (size_t i = 0; i < len; ++i) {
+            a_ += p[i];
+            b_ += static_cast<uint32_t>(len - i) * p[i];
+        }
+    }
+
+    void roll(uint8_t out, uint8_t in) {
+        a_ += static_cast<uint32_t>(in) - out;
+        b_ += a_ - len_ * out;
+    }
+
+    uint32_t value() const { return (a_ & 0xFFFFu) | (b_ << 16); }
+
+private:
+    uint32_t a_ = 0;
+    uint32_t b_ = 0;
+    uint32_t len_ = 0;
+};
+
+} // namespace detail
+
+enum class PatchOpKind : uint8_t { Copy = 0, Literal = 1 };
+
+// Positions and lengths are in elements. A Copy takes len elements from the base at src; a
+// Literal takes them from Patch::literals starting at src. Ranges not covered by any op keep
+// the base's element at the same position.
+struct PatchOp {
+    PatchOpKind kind;
+    size_t dst;
+    size_t src;
+    size_t len;
+};
+
+template <typename T>
+struct Patch {
+    static constexpr uint32_t kMagic = 0x48435450u;
+
+    size_t old_size = 0;
+    size_t new_size = 0;
+    uint64_t base_hash = 0;
+    Vector<PatchOp> ops;
+    Vector<T> literals;
+
+    bool empty() const { return ops.empty() && old_size == new_size; }
+
+    Vector<uint8_t> serialize() const {
+        ByteBuffer out(64 + ops.size() * 8 + literals.size() * sizeof(T));
+        out.put_u32(kMagic);
+        out.put_u8(static_cast<uint8_t>(sizeof(T)));
+        out.put_varint(old_size);
+        out.put_varint(new_size);
+        out.put_u64(base_hash);
+        out.put_varint(ops.size());
+        out.put_varint(literals.size());
+        size_t cursor = 0;
+        for (size_t i = 0; i < ops.size(); ++i) {
+            const PatchOp& op = ops[i];
+            out.put_u8(static_cast<uint8_t>(op.kind));
+            out.put_varint(op.dst - cursor);
+            out.put_varint(op.len);
+            if (op.kind == PatchOpKind::Copy) {
+                out.put_svarint(static_cast<int64_t>(op.src - op.dst));
+            }
+            cursor = op.dst + op.len;
+        }
+        out.append_bytes(literals.data(), literals.size() * sizeof(T));
+        return out.take();
+    }
+
+    // Rejects truncated or inconsistent input before allocating for it. Every bound is checked
+    // by subtraction from a limit already known to hold, so no length in the input can wrap.
+    static Patch deserialize(const uint8_t* data, size_t n) {
+        ByteReader in(data, n);
+        if (in.read_u32() != kMagic || in.read_u8() != sizeof(T)) {
+            VECTOR_THROW(std::invalid_argument("Patch: bad header or element size"));
+        }
+        Patch patch;
+        patch.old_size = in.read_varint();
+        patch.new_size = in.read_varint();
+        patch.base_hash = in.read_u64();
+        size_t op_count = in.read_varint();
+        size_t literal_count = in.read_varint();
+        // An op takes at least three bytes (kind, gap, length).
+        if (op_count > in.remaining() / 3 || literal_count > in.remaining() / sizeof(T)) {
+            VECTOR_THROW(std::invalid_argument("Patch: counts exceed input size"));
+        }
+        patch.ops.reserve(op_count);
+        size_t cursor = 0;
+        size_t literal_cursor = 0;
+        for (size_t i = 0; i < op_count; ++i) {
+            PatchOp op;
+            op.kind = static_cast<PatchOpKind>(in.read_u8());
+            uint64_t gap = in.read_varint();
+            if (gap > patch.new_size - cursor) {
+                VECTOR_THROW(std::invalid_argument("Patch: op out of range"));
+            }
+            op.dst = cursor + gap;
+            op.len = in.read_varint();
+            if (op.len > patch.new_size - op.dst) {
+                VECTOR_THROW(std::invalid_argument("Patch: op out of range"));
+            }
+            if (op.kind == PatchOpKind::Copy) {
+                int64_t delta = in.read_svarint();
+                uint64_t magnitude = delta < 0 ? 0 - static_cast<uint64_t>(delta) : static_cast<uint64_t>(delta);
+                if (delta < 0 ? magnitude > op.dst : (magnitude > patch.old_size || op.dst > patch.old_size - magnitude)) {
+                    VECTOR_THROW(std::invalid_argument("Patch: op out of range"));
+                }
+                op.src = delta < 0 ? op.dst - magnitude : op.dst + magnitude;
+                if (op.src > patch.old_size || op.len > patch.old_size - op.src) {
+                    VECTOR_THROW(std::invalid_argument("Patch: op out of range"));
+                }
+            } else if (op.kind == PatchOpKind::Literal) {
+                if (op.len > literal_count - literal_cursor) {
+                    VECTOR_THROW(std::invalid_argument("Patch: literal section size mismatch"));
+                }
+                op.src = literal_cursor;
+                literal_cursor += op.len;
+            } else {
+                VECTOR_THROW(std::invalid_argument("Patch: unknown op"));
+            }
+            cursor = op.dst + op.len;
+            patch.ops.push_back(op);
+        }
+        if (literal_cursor != literal_count || in.remaining() != literal_count * sizeof(T)) {
+            VECTOR_THROW(std::invalid_argument("Patch: literal section size mismatch"));
+        }
+        patch.literals.resize_for_overwrite(literal_count);
+        in.read_bytes(patch.literals.data(), literal_count * sizeof(T));
+        return patch;
+    }
+};
+
+template <typename T>
+struct DiffOptions {
+    // Granularity of the rolling-hash index over the old vector.
+    size_t block_elements = std::max<size_t>(1, 64 / sizeof(T));
+    // Unchanged runs shorter than this are folded into the surrounding literal.
+    size_t min_skip_elements = std::max<size_t>(1, 16 / sizeof(T));
+};
+
+// Computes a patch turning old_vec into new_vec. Unchanged regions are found with SIMD byte
+// comparison at the same position; shifted data (insertions and deletions upstream of it) is
+// found through a rolling-hash index of old_vec. A copy moving data towards the end is only
+// emitted when its destination cannot overlap the source of an earlier copy moving data towards
+// the front; with that invariant apply() can work inside the destination buffer.
+template <typename T, typename A1, typename A2>
+Patch<T> diff(const Vector<T, A1>& old_vec, const Vector<T, A2>& new_vec, const DiffOptions<T>& options = DiffOptions<T>()) {
+    static_assert(std::is_trivially_copyable_v<T>, "diff works on the raw bytes of trivially copyable elements");
+    Patch<T> patch;
+    patch.old_size = old_vec.size();
+    patch.new_size = new_vec.size();
+    patch.base_hash = hash_bytes(old_vec.data(), old_vec.size() * sizeof(T));
+
+    const size_t B = options.block_elements;
+    const size_t block_bytes = B * sizeof(T);
+    const auto* old_bytes = reinterpret_cast<const uint8_t*>(old_vec.data());
+    const auto* new_bytes = reinterpret_cast<const uint8_t*>(new_vec.data());
+    const size_t old_n = old_vec.size();
+    const size_t new_n = new_vec.size();
+
+    size_t blocks = old_n / B;
+    size_t table_size = 1;
+    while (table_size < blocks * 2) {
+        table_size <<= 1;
+    }
+    constexpr uint32_t kNone = 0xFFFFFFFFu;
+    // Periodic data puts every block in one chain; only its first candidates are tried.
+    constexpr size_t kMaxCandidates = 32;
+    Vector<uint32_t> heads(table_size, kNone);
+    Vector<uint32_t> next(blocks, kNone);
+    Vector<uint32_t> weak(blocks);
+    detail::RollingChecksum sum;
+    // Inserted in descending order so each chain lists blocks by ascending position.
+    for (size_t k = blocks; k-- > 0;) {
+        sum.reset(old_bytes + k * block_bytes, block_bytes);
+        weak[k] = sum.value();
+        uint32_t slot = static_cast<uint32_t>(detail::hash_mix(weak[k], detail::kHashP0)) & (table_size - 1);
+        next[k] = heads[slot];
+        heads[slot] = static_cast<uint32_t>(k);
+    }
+
+    size_t literal_start = 0;
+    bool in_literal = false;
+    auto flush_literal = [&](size_t end) {
+        if (in_literal && end > literal_start) {
+            PatchOp op{PatchOpKind::Literal, literal_start, patch.literals.size(), end - literal_start};
+            for (size_t j = literal_start; j < end; ++j) {
+                patch.literals.push_back(new_vec[j]);
+            }
+            patch.ops.push_back(op);
+        }
+        in_literal = false;
+    };
+
+    size_t i = 0;
+    size_t left_source_end = 0;
+    bool rolling_valid = false;
+    while (i < new_n) {
+        if (i < old_n) {
+            size_t limit = std::min(old_n, new_n) - i;
+            size_t same = detail::mismatch_bytes(old_bytes + i * sizeof(T), new_bytes + i * sizeof(T), limit * sizeof(T)) / sizeof(T);
+            if (same >= options.min_skip_elements || (same > 0 && !in_literal)) {
+                flush_literal(i);
+                i += same;
+                rolling_valid = false;
+                continue;
+            }
+        }
+        if (blocks > 0 && i + B <= new_n) {
+            if (!rolling_valid) {
+                sum.reset(new_bytes + i * sizeof(T), block_bytes);
+                rolling_valid = true;
+            }
+            uint32_t slot = static_cast<uint32_t>(detail::hash_mix(sum.value(), detail::kHashP0)) & (table_size - 1);
+            size_t best_src = 0;
+            size_t best_len = 0;
+            size_t candidates = 0;
+            for (uint32_t k = heads[slot]; k != kNone && candidates < kMaxCandidates; k = next[k], ++candidates) {
+                size_t src = static_cast<size_t>(k) * B;
+                if (src == i || (src < i && i < left_source_end) || weak[k] != sum.value()) {
+                    continue;
+                }
+                size_t limit = std::min(old_n - src, new_n - i);
+                size_t len = detail::mismatch_bytes(old_bytes + src * sizeof(T), new_bytes + i * sizeof(T), limit * sizeof(T)) / sizeof(T);
+                if (len >= B && len > best_len) {
+                    best_len = len;
+                    best_src = src;
+                    if (len == limit) {
+                        break;
+                    }
+                }
+            }
+            if (best_len > 0) {
+                flush_literal(i);
+                patch.ops.push_back(PatchOp{PatchOpKind::Copy, i, best_src, best_len});
+                if (best_src > i) {
+                    left_source_end = std::max(left_source_end, best_src + best_len);
+                }
+                i += best_len;
+                rolling_valid = false;
+                continue;
+            }
+        }
+        if (!in_literal) {
+            in_literal = true;
+            literal_start = i;
+        }
+        if (rolling_valid && i + B < new_n) {
+            const uint8_t* window = new_bytes + i * sizeof(T);
+            for (size_t b = 0; b < sizeof(T); ++b) {
+                sum.roll(window[b], window[block_bytes + b]);
+            }
+        } else {
+            rolling_valid = false;
+        }
+        ++i;
+    }
+    flush_literal(new_n);
+    return patch;
+}
+
+// Applies patch to vec in place: copies moving data towards the end run first in descending
+// destination order, then copies towards the front in ascending order, then literals. diff()
+// orders its ops so that no copy's source has been overwritten by the time it is read.
+// With verify, the base is hashed first and a mismatch throws before vec is modified.
+template <typename T, typename Allocator>
+void apply(Vector<T, Allocator>& vec, const Patch<T>& patch, bool verify = false) {
+    static_assert(std::is_trivially_copyable_v<T>, "apply works on trivially copyable elements");
+    if (vec.size() != patch.old_size) {
+        VECTOR_THROW(std::invalid_argument("Patch: base size mismatch"));
+    }
+    if (verify && hash_bytes(vec.data(), vec.size() * sizeof(T)) != patch.base_hash) {
+        VECTOR_THROW(std::invalid_argument("Patch: base content mismatch"));
+    }
+    if (patch.new_size > vec.size()) {
+        vec.resize(patch.new_size);
+    }
+    T* data = vec.data();
+    const size_t n = patch.ops.size();
+    for (size_t i = n; i-- > 0;) {
+        const PatchOp& op = patch.ops[i];
+        if (op.kind == PatchOpKind::Copy && op.src < op.dst) {
+            std::memmove(static_cast<void*>(data + op.dst), data + op.src, op.len * sizeof(T));
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        const PatchOp& op = patch.ops[i];
+        if (op.kind == PatchOpKind::Copy && op.src > op.dst) {
+            std::memmove(static_cast<void*>(data + op.dst), data + op.src, op.len * sizeof(T));
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        const PatchOp& op = patch.ops[i];
+        if (op.kind == PatchOpKind::Literal) {
+            std::memcpy(static_cast<void*>(data + op.dst), patch.literals.data() + op.src, op.len * sizeof(T));
+        }
+    }
+    if (patch.new_size < vec.size()) {
+        vec.resize(patch.new_size);
+    }
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "customVector.hpp"
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+// wyhash-style 64-bit hash: three independent multiply-xor lanes over 48-byte stripes, so the
+// 64x64->128 multiplies of consecutive lanes overlap. The zero-padded tail and the total length
+// are folded in at the end, which makes the streaming and one-shot forms produce the same value.
+namespace detail {
+
+constexpr uint64_t kHashP0 = 0xa0761d6478bd642full;
+constexpr uint64_t kHashP1 = 0xe7037ed1a0b428dbull;
+constexpr uint64_t kHashP2 = 0x8ebc6af09c88c6e3ull;
+constexpr uint64_t kHashP3 = 0x589965cc75374cc3ull;
+constexpr size_t kHashStripe = 48;
+
+inline uint64_t hash_mix(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    __extension__ using uint128 = unsigned __int128;
+    uint128 r = static_cast<uint128>(a) * b;
+    return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+#else
+    uint64_t a_lo = a & 0xFFFFFFFFu, a_hi = a >> 32;
+    uint64_t b_lo = b & 0xFFFFFFFFu, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+    uint64_t hi = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    uint64_t lo = (cross << 32) | (lo_lo & 0xFFFFFFFFu);
+    return lo ^ hi;
+#endif
+}
+
+inline uint64_t hash_read64(const unsigned char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t hash_read_partial(const unsigned char* p, size_t n) {
+    uint64_t v = 0;
+    std::memcpy(&v, p, n);
+    return v;
+}
+
+} // namespace detail
+
+class Hasher {
+public:
+    explicit Hasher(uint64_t seed = 0) : lanes_{seed ^ detail::kHashP0, seed ^ detail::kHashP1, seed ^ detail::kHashP2},
+        length_(0), buffered_(0) {}
+
+    void update(const void* data, size_t n) {
+        if (n == 0) {
+            return;
+        }
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        length_ += n;
+        if (buffered_ + n <= detail::kHashStripe) {
+            std::memcpy(buffer_ + buffered_, p, n);
+            buffered_ += n;
+            return;
+        }
+        if (buffered_ > 0) {
+            size_t fill = detail::kHashStripe - buffered_;
+            std::memcpy(buffer_ + buffered_, p, fill);
+            p += fill;
+            n -= fill;
+            stripe(buffer_);
+            buffered_ = 0;
+        }
+        while (n > detail::kHashStripe) {
+            stripe(p);
+            p += detail::kHashStripe;
+            n -= detail::kHashStripe;
+        }
+        std::memcpy(buffer_, p, n);
+        buffered_ = n;
+    }
+
+    uint64_t finish() const {
+        uint64_t seed = lanes_[0] ^ lanes_[1] ^ lanes_[2];
+        const unsigned char* p = buffer_;
+        size_t n = buffered_;
+        while (n > 16) {
+            seed = detail::hash_mix(detail::hash_read64(p) ^ detail::kHashP1, detail::hash_read64(p + 8) ^ seed);
+            p += 16;
+            n -= 16;
+        }
+        uint64_t a = detail::hash_read_partial(p, std::min<size_t>(n, 8));
+        uint64_t b = (n > 8) ? detail::hash_read_partial(p + 8, n - 8) : 0;
+        return detail::hash_mix(detail::kHashP1 ^ length_, detail::hash_mix(a ^ detail::kHashP1, b ^ seed));
+    }
+
+private:
+    uint64_t lanes_[3];
+    uint64_t length_;
+    size_t buffered_;
+    unsigned char buffer_[detail::kHashStripe];
+
+    void stripe(const unsigned char* p) {
+        lanes_[0] = detail::hash_mix(detail::hash_read64(p) ^ detail::kHashP1, detail::hash_read64(p + 8) ^ lanes_[0]);
+        lanes_[1] = detail::hash_mix(detail::hash_read64(p + 16) ^ detail::kHashP2, detail::hash_read64(p + 24) ^ lanes_[1]);
+        lanes_[2] = detail::hash_mix(detail::hash_read64(p + 32) ^ detail::kHashP3, detail::hash_read64(p + 40) ^ lanes_[2]);
+    }
+};
+
+inline uint64_t hash_bytes(const void* data, size_t n, uint64_t seed = 0) {
+    Hasher hasher(seed);
+    hasher.update(data, n);
+    return hasher.finish();
+}
+
+template <typename T>
+constexpr bool is_bytewise_hashable_v = std::is_trivially_copyable_v<T> && std::has_unique_object_representations_v<T>;
+
+template <typename T>
+void hash_elements(Hasher& hasher, const T* first, size_t n) {
+    if constexpr (is_bytewise_hashable_v<T>) {
+        hasher.update(first, n * sizeof(T));
+    } else {
+        std::hash<T> element_hash;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t h = static_cast<uint64_t>(element_hash(first[i]));
+            hasher.update(&h, sizeof(h));
+        }
+    }
+}
+
+template <typename T, typename Allocator>
+uint64_t hash(const Vector<T, Allocator>& vec, uint64_t seed = 0) {
+    Hasher hasher(seed);
+    hash_elements(hasher, vec.data(), vec.size());
+    return hasher.finish();
+}
+
+// Hash of an append-only Vector that only consumes the elements added since the last update().
+// value() equals hash(vec, seed) for the elements seen so far.
+template <typename T>
+class IncrementalHash {
+public:
+    explicit IncrementalHash(uint64_t seed = 0) : hasher_(seed), consumed_(0) {}
+
+    template <typename Allocator>
+    void update(const Vector<T, Allocator>& vec) {
+        if (vec.size() < consumed_) {
+            VECTOR_THROW(std::logic_error("IncrementalHash requires an append-only Vector"));
+        }
+        hash_elements(hasher_, vec.data() + consumed_, vec.size() - consumed_);
+        consumed_ = vec.size();
+    }
+
+    uint64_t value() const { return hasher_.finish(); }
+    size_t consumed() const { return consumed_; }
+
+private:
+    Hasher hasher_;
+    size_t consumed_;
+};
+
+namespace std {
+template <typename T, typename Allocator>
+struct hash<Vector<T, Allocator>> {
+    size_t operator()(const Vector<T, Allocator>& vec) const {
+        return static_cast<size_t>(::hash(vec));
+    }
+};
+} // namespace std
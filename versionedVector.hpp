@@ -0,0 +1,315 @@
+#pragma once
+
+#include "customVector.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+// Multi-version Vector of fixed size. The elements are split into chunks; each chunk keeps a
+// newest-first list of immutable versions tagged with the commit timestamp that produced them.
+// Writers copy the chunks they touch, link the copies in and publish a new timestamp; readers
+// pin a snapshot timestamp and see the newest version of each chunk not after it, without
+// taking any lock. Versions that no active snapshot can reach are freed by collect_garbage(),
+// either on demand or from a background thread.
+//
+// Writers and the collector are serialized by a mutex. Snapshots must be released before the
+// VersionedVector is destroyed.
+template <typename T, typename Allocator = SimpleAllocator<T>>
+class VersionedVector {
+    struct Version {
+        uint64_t timestamp;
+        std::atomic<Version*> next;
+        Vector<T, Allocator> values;
+    };
+
+public:
+    static constexpr size_t kDefaultChunkElements = 1024;
+    static constexpr size_t kDefaultMaxSnapshots = 64;
+
+    VersionedVector(size_t n, const T& value, size_t chunk_elements = kDefaultChunkElements,
+                    size_t max_snapshots = kDefaultMaxSnapshots)
+        : size_(n), chunk_elements_(std::max<size_t>(1, chunk_elements)), heads_(chunk_count()),
+          pending_(chunk_count(), nullptr), pins_(max_snapshots) {
+        for (size_t c = 0; c < chunk_count(); ++c) {
+            Version* v = new Version{kInitialTimestamp, {nullptr}, Vector<T, Allocator>(chunk_size(c), value)};
+            heads_[c].store(v, std::memory_order_relaxed);
+        }
+        versions_.store(chunk_count(), std::memory_order_relaxed);
+    }
+
+    explicit VersionedVector(const Vector<T, Allocator>& values, size_t chunk_elements = kDefaultChunkElements,
+                             size_t max_snapshots = kDefaultMaxSnapshots)
+        : size_(values.size()), chunk_elements_(std::max<size_t>(1, chunk_elements)), heads_(chunk_count()),
+          pending_(chunk_count(), nullptr), pins_(max_snapshots) {
+        for (size_t c = 0; c < chunk_count(); ++c) {
+            const T* first = values.data() + c * chunk_elements_;
+            Version* v = new Version{kInitialTimestamp, {nullptr}, Vector<T, Allocator>(first, first + chunk_size(c))};
+            heads_[c].store(v, std::memory_order_relaxed);
+        }
+        versions_.store(chunk_count(), std::memory_order_relaxed);
+    }
+
+    VersionedVector(const VersionedVector&) = delete;
+    VersionedVector& operator=(const VersionedVector&) = delete;
+
+    ~VersionedVector() {
+        stop_background_gc();
+        for (size_t c = 0; c < heads_.size(); ++c) {
+            free_chain(heads_[c].load(std::memory_order_relaxed));
+        }
+    }
+
+    size_t size() const noexcept { return size_; }
+    size_t chunk_elements() const noexcept { return chunk_elements_; }
+    size_t chunk_count() const noexcept { return (size_ + chunk_elements_ - 1) / chunk_elements_; }
+    uint64_t latest_timestamp() const noexcept { return committed_.load(std::memory_order_seq_cst); }
+
+    // A pinned, consistent view as of one commit. Versions it can see are not collected until it
+    // is destroyed.
+    class Snapshot {
+    public:
+        Snapshot(Snapshot&& other) noexcept : owner_(other.owner_), slot_(other.slot_), timestamp_(other.timestamp_) {
+            other.owner_ = nullptr;
+        }
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        Snapshot& operator=(Snapshot&&) = delete;
+
+        ~Snapshot() {
+            if (owner_ != nullptr) {
+                owner_->pins_[slot_].store(0, std::memory_order_release);
+            }
+        }
+
+        uint64_t timestamp() const noexcept { return timestamp_; }
+        size_t size() const noexcept { return owner_->size_; }
+
+        // Elements of chunk c as of this snapshot; the pointer stays valid while it is pinned.
+        const T* chunk(size_t c) const { return owner_->visible(c, timestamp_)->values.data(); }
+        size_t chunk_size(size_t c) const { return owner_->chunk_size(c); }
+
+        const T& operator[](size_t index) const {
+            return chunk(index / owner_->chunk_elements_)[index % owner_->chunk_elements_];
+        }
+
+        template <typename OutAllocator>
+        void copy_to(Vector<T, OutAllocator>& out) const {
+            out.reserve(out.size() + owner_->size_);
+            for (size_t c = 0; c < owner_->chunk_count(); ++c) {
+                const T* p = chunk(c);
+                for (size_t i = 0; i < chunk_size(c); ++i) {
+                    out.push_back(p[i]);
+                }
+            }
+        }
+
+    private:
+        friend class VersionedVector;
+        Snapshot(const VersionedVector* owner, size_t slot, uint64_t timestamp)
+            : owner_(owner), slot_(slot), timestamp_(timestamp) {}
+
+        const VersionedVector* owner_;
+        size_t slot_;
+        uint64_t timestamp_;
+    };
+
+    // Pins the latest committed state. Lock-free; throws if all snapshot slots are in use.
+    Snapshot snapshot() const {
+        uint64_t ts = committed_.load(std::memory_order_seq_cst);
+        for (size_t slot = 0; slot < pins_.size(); ++slot) {
+            uint64_t expected = 0;
+            if (!pins_[slot].compare_exchange_strong(expected, ts, std::memory_order_seq_cst)) {
+                continue;
+            }
+            // The collector reads the commit clock before scanning pins, so once the clock is seen
+            // unchanged after publishing the pin, no collection can have missed it.
+            for (;;) {
+                uint64_t now = committed_.load(std::memory_order_seq_cst);
+                if (now == ts) {
+                    return Snapshot(this, slot, ts);
+                }
+                ts = now;
+                pins_[slot].store(ts, std::memory_order_seq_cst);
+            }
+        }
+        VECTOR_THROW(std::runtime_error("VersionedVector: too many active snapshots"));
+    }
+
+    // Buffers copy-on-write chunk versions and publishes them atomically under one timestamp.
+    // Holds the writer lock for its lifetime; an uncommitted batch is discarded on destruction.
+    class WriteBatch {
+    public:
+        WriteBatch(WriteBatch&& other) noexcept : owner_(other.owner_), lock_(std::move(other.lock_)) {
+            other.owner_ = nullptr;
+        }
+        WriteBatch(const WriteBatch&) = delete;
+        WriteBatch& operator=(const WriteBatch&) = delete;
+        WriteBatch& operator=(WriteBatch&&) = delete;
+
+        ~WriteBatch() {
+            if (owner_ != nullptr) {
+                owner_->discard_pending();
+            }
+        }
+
+        void set(size_t index, const T& value) { mutable_at(index) = value; }
+
+        T& mutable_at(size_t index) {
+            if (index >= owner_->size_) {
+                VECTOR_THROW(std::out_of_range("VersionedVector index out of range"));
+            }
+            Version* v = owner_->pending_version(index / owner_->chunk_elements_);
+            return v->values[index % owner_->chunk_elements_];
+        }
+
+        // Returns the commit timestamp, visible to snapshots taken from now on.
+        uint64_t commit() {
+            uint64_t ts = owner_->publish_pending();
+            owner_ = nullptr;
+            lock_.unlock();
+            return ts;
+        }
+
+    private:
+        friend class VersionedVector;
+        explicit WriteBatch(VersionedVector* owner) : owner_(owner), lock_(owner->writer_mutex_) {}
+
+        VersionedVector* owner_;
+        std::unique_lock<std::mutex> lock_;
+    };
+
+    WriteBatch write() { return WriteBatch(this); }
+
+    uint64_t set(size_t index, const T& value) {
+        WriteBatch batch = write();
+        batch.set(index, value);
+        return batch.commit();
+    }
+
+    // Frees every version older than the one each chunk shows to the oldest active snapshot.
+    // Returns the number of versions freed.
+    size_t collect_garbage() {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        uint64_t oldest = committed_.load(std::memory_order_seq_cst);
+        for (size_t slot = 0; slot < pins_.size(); ++slot) {
+            uint64_t pinned = pins_[slot].load(std::memory_order_seq_cst);
+            if (pinned != 0 && pinned < oldest) {
+                oldest = pinned;
+            }
+        }
+        size_t freed = 0;
+        for (size_t c = 0; c < heads_.size(); ++c) {
+            Version* keep = visible(c, oldest);
+            freed += free_chain(keep->next.exchange(nullptr, std::memory_order_relaxed));
+        }
+        versions_.fetch_sub(freed, std::memory_order_relaxed);
+        return freed;
+    }
+
+    // Committed versions still held, including each chunk's newest one; uncommitted batch copies
+    // are not counted. Takes no lock, so it is safe to call while this thread holds a WriteBatch.
+    size_t version_count() const noexcept { return versions_.load(std::memory_order_relaxed); }
+
+    void start_background_gc(std::chrono::milliseconds interval) {
+        stop_background_gc();
+        gc_stop_ = false;
+        gc_thread_ = std::thread([this, interval] {
+            std::unique_lock<std::mutex> lock(gc_mutex_);
+            while (!gc_wake_.wait_for(lock, interval, [this] { return gc_stop_; })) {
+                lock.unlock();
+                collect_garbage();
+                lock.lock();
+            }
+        });
+    }
+
+    void stop_background_gc() {
+        if (!gc_thread_.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(gc_mutex_);
+            gc_stop_ = true;
+        }
+        gc_wake_.notify_all();
+        gc_thread_.join();
+    }
+
+private:
+    static constexpr uint64_t kInitialTimestamp = 1;
+
+    size_t size_;
+    size_t chunk_elements_;
+    Vector<std::atomic<Version*>> heads_;
+    Vector<Version*> pending_;
+    Vector<size_t> touched_;
+    mutable Vector<std::atomic<uint64_t>> pins_;
+    std::atomic<uint64_t> committed_{kInitialTimestamp};
+    std::atomic<size_t> versions_{0};
+    mutable std::mutex writer_mutex_;
+
+    std::thread gc_thread_;
+    std::mutex gc_mutex_;
+    std::condition_variable gc_wake_;
+    bool gc_stop_ = false;
+
+    size_t chunk_size(size_t c) const { return std::min(chunk_elements_, size_ - c * chunk_elements_); }
+
+    Version* visible(size_t c, uint64_t timestamp) const {
+        Version* v = heads_[c].load(std::memory_order_acquire);
+        while (v->timestamp > timestamp) {
+            v = v->next.load(std::memory_order_acquire);
+        }
+        return v;
+    }
+
+    Version* pending_version(size_t c) {
+        if (pending_[c] == nullptr) {
+            // Grown first so that the push below cannot throw once the copy is published.
+            if (touched_.size() == touched_.capacity()) {
+                touched_.reserve(std::max<size_t>(8, touched_.capacity() * 2));
+            }
+            Version* head = heads_[c].load(std::memory_order_relaxed);
+            pending_[c] = new Version{0, {head}, head->values};
+            touched_.push_back(c);
+        }
+        return pending_[c];
+    }
+
+    uint64_t publish_pending() {
+        uint64_t ts = committed_.load(std::memory_order_relaxed) + 1;
+        for (size_t i = 0; i < touched_.size(); ++i) {
+            size_t c = touched_[i];
+            pending_[c]->timestamp = ts;
+            heads_[c].store(pending_[c], std::memory_order_release);
+            pending_[c] = nullptr;
+        }
+        versions_.fetch_add(touched_.size(), std::memory_order_relaxed);
+        touched_.clear();
+        committed_.store(ts, std::memory_order_seq_cst);
+        return ts;
+    }
+
+    void discard_pending() {
+        for (size_t i = 0; i < touched_.size(); ++i) {
+            delete pending_[touched_[i]];
+            pending_[touched_[i]] = nullptr;
+        }
+        touched_.clear();
+    }
+
+    static size_t free_chain(Version* v) {
+        size_t freed = 0;
+        while (v != nullptr) {
+            Version* next = v->next.load(std::memory_order_relaxed);
+            delete v;
+            v = next;
+            ++freed;
+        }
+        return freed;
+    }
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "customVector.hpp"
+#include <thread>
+
+namespace detail {
+
+// Joins every started worker on scope exit, so a failed thread launch (or a throw on the
+// calling thread) never destroys a joinable std::thread.
+struct WorkerJoiner {
+    Vector<std::thread>& workers;
+
+    ~WorkerJoiner() {
+        for (auto& worker : workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+};
+
+} // namespace detail